@@ -91,6 +91,90 @@ private:
     elapsed_type m_when;
 };
 
+//------------------------------------------------------------------------------
+
+/** A DecayingSample which may be used from many threads without a lock.
+
+    The value and the time it was last aged are packed into one atomic
+    word, so adding a sample is a compare-and-swap loop and reading the
+    value is a single load.
+*/
+template <int Window>
+class AtomicDecayingSample
+{
+public:
+    typedef std::int32_t value_type;
+    typedef std::int32_t elapsed_type;
+
+    AtomicDecayingSample ()
+        : m_state (pack (0, 0))
+    {
+    }
+
+    /** Add a new sample.
+        The value is first aged according to the specified time.
+    */
+    value_type add (value_type value, elapsed_type now)
+    {
+        std::uint64_t state (m_state.load ());
+        value_type result;
+
+        for (;;)
+        {
+            // Another thread may have aged the value past our time
+            elapsed_type const when (std::max (now, when_of (state)));
+            result = decayed (state, when) + value;
+
+            if (m_state.compare_exchange_weak (state, pack (result, when)))
+                break;
+        }
+
+        return result / Window;
+    }
+
+    /** Retrieve the current value in normalized units.
+        The samples are aged according to the specified time.
+    */
+    value_type value (elapsed_type now) const
+    {
+        return decayed (m_state.load (), now) / Window;
+    }
+
+private:
+    static std::uint64_t pack (value_type value, elapsed_type when)
+    {
+        return (std::uint64_t (std::uint32_t (value)) << 32) | std::uint32_t (when);
+    }
+
+    static elapsed_type when_of (std::uint64_t state)
+    {
+        return static_cast <elapsed_type> (state & 0xffffffff);
+    }
+
+    // Returns the packed value aged to the specified time.
+    static value_type decayed (std::uint64_t state, elapsed_type now)
+    {
+        value_type value (static_cast <value_type> (state >> 32));
+        elapsed_type n (now - when_of (state));
+
+        if (value == 0 || n <= 0)
+            return value;
+
+        // A span larger than four times the window decays the
+        // value to an insignificant amount so just reset it.
+        //
+        if (n > 4 * Window)
+            return 0;
+
+        while (n--)
+            value -= (value + Window - 1) / Window;
+
+        return value;
+    }
+
+    std::atomic <std::uint64_t> m_state;
+};
+
 }
 
 #endif
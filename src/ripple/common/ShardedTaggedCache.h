@@ -0,0 +1,279 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SHARDEDTAGGEDCACHE_H_INCLUDED
+#define RIPPLE_SHARDEDTAGGEDCACHE_H_INCLUDED
+
+#include <ripple/common/TaggedCache.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+
+/** A TaggedCache partitioned into independently locked shards.
+
+    Each key is assigned to a shard using the high bits of its hash, and
+    each shard is a complete TaggedCache with its own mutex. Threads which
+    access different keys rarely contend for the same lock, and a sweep
+    only holds one shard's lock at a time.
+
+    The interface matches TaggedCache so that a cache can be switched
+    between the two by changing its type. Because there is no single mutex
+    guarding the whole cache, `peekMutex` is not provided.
+
+    The number of shards is rounded up to a power of two. The target size
+    is divided evenly among the shards, and statistics are aggregated.
+*/
+template <
+    class Key,
+    class T,
+    class Hash = beast::hardened_hash <Key>,
+    class KeyEqual = std::equal_to <Key>,
+    class Mutex = std::recursive_mutex
+>
+class ShardedTaggedCache
+{
+private:
+    typedef TaggedCache <Key, T, Hash, KeyEqual, Mutex> shard_type;
+
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef typename shard_type::weak_mapped_ptr weak_mapped_ptr;
+    typedef typename shard_type::mapped_ptr mapped_ptr;
+    typedef beast::abstract_clock <std::chrono::seconds> clock_type;
+
+    enum
+    {
+        defaultShardCount = 16
+    };
+
+public:
+    ShardedTaggedCache (std::string const& name, int size,
+        clock_type::rep expiration_seconds, clock_type& clock, beast::Journal journal,
+            beast::insight::Collector::ptr const& collector = beast::insight::NullCollector::New (),
+                std::size_t shardCount = defaultShardCount)
+        : m_stats (name,
+            std::bind (&ShardedTaggedCache::collect_metrics, this),
+                collector)
+        , m_shift (std::numeric_limits <std::size_t>::digits)
+    {
+        std::size_t shards = 1;
+        while (shards < shardCount)
+        {
+            shards <<= 1;
+            --m_shift;
+        }
+
+        m_shards.reserve (shards);
+        for (std::size_t i = 0; i < shards; ++i)
+            m_shards.emplace_back (new shard_type (name,
+                shardTargetSize (size, shards), expiration_seconds,
+                    clock, journal));
+    }
+
+    /** Return the clock associated with the cache. */
+    clock_type& clock ()
+    {
+        return m_shards.front ()->clock ();
+    }
+
+    /** Return the number of independently locked shards. */
+    std::size_t getShardCount () const
+    {
+        return m_shards.size ();
+    }
+
+    int getTargetSize () const
+    {
+        int size = 0;
+        for (auto const& shard : m_shards)
+            size += shard->getTargetSize ();
+        return size;
+    }
+
+    void setTargetSize (int s)
+    {
+        for (auto& shard : m_shards)
+            shard->setTargetSize (shardTargetSize (s, m_shards.size ()));
+    }
+
+    clock_type::rep getTargetAge () const
+    {
+        return m_shards.front ()->getTargetAge ();
+    }
+
+    void setTargetAge (clock_type::rep s)
+    {
+        for (auto& shard : m_shards)
+            shard->setTargetAge (s);
+    }
+
+    int getCacheSize ()
+    {
+        int size = 0;
+        for (auto& shard : m_shards)
+            size += shard->getCacheSize ();
+        return size;
+    }
+
+    int getTrackSize ()
+    {
+        int size = 0;
+        for (auto& shard : m_shards)
+            size += shard->getTrackSize ();
+        return size;
+    }
+
+    float getHitRate ()
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        getStats (hits, misses);
+        auto const total = static_cast<float> (hits + misses);
+        return hits * (100.0f / std::max (1.0f, total));
+    }
+
+    void clearStats ()
+    {
+        for (auto& shard : m_shards)
+            shard->clearStats ();
+    }
+
+    void clear ()
+    {
+        for (auto& shard : m_shards)
+            shard->clear ();
+    }
+
+    void sweep ()
+    {
+        for (auto& shard : m_shards)
+            shard->sweep ();
+    }
+
+    bool del (const key_type& key, bool valid)
+    {
+        return shard (key).del (key, valid);
+    }
+
+    /** Replace aliased objects with originals.
+        @see TaggedCache::canonicalize
+    */
+    bool canonicalize (const key_type& key, std::shared_ptr<T>& data, bool replace = false)
+    {
+        return shard (key).canonicalize (key, data, replace);
+    }
+
+    std::shared_ptr<T> fetch (const key_type& key)
+    {
+        return shard (key).fetch (key);
+    }
+
+    bool insert (key_type const& key, T const& value)
+    {
+        return shard (key).insert (key, value);
+    }
+
+    bool retrieve (const key_type& key, T& data)
+    {
+        return shard (key).retrieve (key, data);
+    }
+
+    bool refreshIfPresent (const key_type& key)
+    {
+        return shard (key).refreshIfPresent (key);
+    }
+
+private:
+    static int shardTargetSize (int size, std::size_t shards)
+    {
+        // Zero means no target, and must stay that way
+        if (size <= 0)
+            return size;
+        return static_cast <int> ((size + shards - 1) / shards);
+    }
+
+    shard_type& shard (key_type const& key)
+    {
+        if (m_shards.size () == 1)
+            return *m_shards.front ();
+
+        // The low bits of the hash select the bucket within the
+        // shard's map, so use the high bits to select the shard.
+        return *m_shards [m_hash (key) >> m_shift];
+    }
+
+    void getStats (std::uint64_t& hits, std::uint64_t& misses)
+    {
+        for (auto& shard : m_shards)
+        {
+            std::uint64_t shardHits;
+            std::uint64_t shardMisses;
+            shard->getStats (shardHits, shardMisses);
+            hits += shardHits;
+            misses += shardMisses;
+        }
+    }
+
+    void collect_metrics ()
+    {
+        m_stats.size.set (getCacheSize ());
+
+        {
+            beast::insight::Gauge::value_type hit_rate (0);
+            {
+                std::uint64_t hits = 0;
+                std::uint64_t misses = 0;
+                getStats (hits, misses);
+                auto const total (hits + misses);
+                if (total != 0)
+                    hit_rate = (hits * 100) / total;
+            }
+            m_stats.hit_rate.set (hit_rate);
+        }
+    }
+
+private:
+    struct Stats
+    {
+        template <class Handler>
+        Stats (std::string const& prefix, Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge (prefix, "size"))
+            , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            { }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+    };
+
+    Stats m_stats;
+    Hash m_hash;
+    int m_shift;
+    std::vector <std::unique_ptr <shard_type>> m_shards;
+};
+
+}
+
+#endif
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SLABALLOCATOR_H_INCLUDED
+#define RIPPLE_SLABALLOCATOR_H_INCLUDED
+
+#include <beast/utility/noexcept.h>
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+
+/** Allocates fixed size blocks of memory carved out of larger slabs.
+
+    Blocks are handed out from a free list, and freed blocks are returned
+    to it for reuse. This avoids the per-allocation bookkeeping of the
+    general purpose heap for objects which are created in large numbers,
+    and keeps them packed together in memory.
+
+    Slabs are only released when the allocator is destroyed.
+
+    @note This class is thread-safe.
+*/
+class SlabAllocator
+{
+public:
+    enum
+    {
+        defaultItemsPerSlab = 1024
+    };
+
+    /** Create the allocator.
+        @param itemSize The size in bytes of each block.
+        @param itemsPerSlab The number of blocks to reserve at a time.
+    */
+    explicit SlabAllocator (std::size_t itemSize,
+        std::size_t itemsPerSlab = defaultItemsPerSlab)
+        : m_itemSize (roundUp (itemSize))
+        , m_itemsPerSlab (itemsPerSlab)
+        , m_free (nullptr)
+        , m_allocated (0)
+    {
+        assert (itemsPerSlab > 0);
+    }
+
+    SlabAllocator (SlabAllocator const&) = delete;
+    SlabAllocator& operator= (SlabAllocator const&) = delete;
+
+    /** Returns the size of each block, after rounding for alignment. */
+    std::size_t getItemSize () const
+    {
+        return m_itemSize;
+    }
+
+    /** Returns the number of blocks currently handed out. */
+    std::size_t getAllocatedCount ()
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+        return m_allocated;
+    }
+
+    /** Returns the number of bytes reserved from the heap. */
+    std::size_t getReservedBytes ()
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+        return m_slabs.size () * m_itemsPerSlab * m_itemSize;
+    }
+
+    /** Returns a block of getItemSize() bytes. */
+    void* allocate ()
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        if (m_free == nullptr)
+            addSlab ();
+
+        FreeItem* const item (m_free);
+        m_free = item->next;
+        ++m_allocated;
+        return item;
+    }
+
+    /** Returns a block obtained from allocate() to the free list. */
+    void deallocate (void* p) noexcept
+    {
+        if (p == nullptr)
+            return;
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        FreeItem* const item (static_cast <FreeItem*> (p));
+        item->next = m_free;
+        m_free = item;
+        --m_allocated;
+    }
+
+private:
+    struct FreeItem
+    {
+        FreeItem* next;
+    };
+
+    // Every block must be able to hold a FreeItem, and be
+    // aligned for any type which fits in it.
+    static std::size_t roundUp (std::size_t size)
+    {
+        std::size_t const align (alignof (std::max_align_t));
+
+        if (size < sizeof (FreeItem))
+            size = sizeof (FreeItem);
+
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    void addSlab ()
+    {
+        // operator new returns memory aligned for any fundamental type
+        std::unique_ptr <char[]> slab (new char [m_itemsPerSlab * m_itemSize]);
+
+        // Thread the new blocks onto the free list in address order
+        for (std::size_t i = m_itemsPerSlab; i-- > 0; )
+        {
+            FreeItem* const item (reinterpret_cast <FreeItem*> (
+                slab.get () + (i * m_itemSize)));
+            item->next = m_free;
+            m_free = item;
+        }
+
+        m_slabs.push_back (std::move (slab));
+    }
+
+private:
+    std::mutex m_mutex;
+    std::size_t const m_itemSize;
+    std::size_t const m_itemsPerSlab;
+    FreeItem* m_free;
+    std::size_t m_allocated;
+    std::vector <std::unique_ptr <char[]>> m_slabs;
+};
+
+}
+
+#endif
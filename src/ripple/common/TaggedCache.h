@@ -149,6 +149,16 @@ public:
         return m_hits * (100.0f / std::max (1.0f, total));
     }
 
+    /** Retrieve the raw hit and miss counts.
+        These are used to combine the statistics of several caches.
+    */
+    void getStats (std::uint64_t& hits, std::uint64_t& misses) const
+    {
+        lock_guard lock (m_mutex);
+        hits = m_hits;
+        misses = m_misses;
+    }
+
     void clearStats ()
     {
         lock_guard lock (m_mutex);
@@ -23,12 +23,22 @@
 #include <beast/container/buffer_view.h>
 
 #include <cstdint>
+#include <string>
 
 namespace ripple {
 
 typedef beast::buffer_view <std::uint8_t> byte_view;
 typedef beast::buffer_view <std::uint8_t const> const_byte_view;
 
+/** Returns a view of the bytes in a string, such as a protocol buffer field.
+    The view is only valid while the string is unchanged.
+*/
+inline const_byte_view make_byte_view (std::string const& s)
+{
+    return const_byte_view (
+        reinterpret_cast <std::uint8_t const*> (s.data ()), s.size ());
+}
+
 }
 
 #endif
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/common/ShardedTaggedCache.h>
+
+#include <beast/unit_test/suite.h>
+#include <beast/chrono/manual_clock.h>
+
+namespace ripple {
+
+class ShardedTaggedCache_test : public beast::unit_test::suite
+{
+public:
+    void run ()
+    {
+        beast::Journal const j;
+
+        beast::manual_clock <std::chrono::seconds> clock;
+        clock.set (0);
+
+        typedef int Key;
+        typedef std::string Value;
+        typedef ShardedTaggedCache <Key, Value> Cache;
+
+        Cache c ("test", 64, 1, clock, j, beast::insight::NullCollector::New (), 5);
+
+        expect (c.getShardCount () == 8);
+        expect (c.getTargetSize () == 64);
+
+        // Insert enough items to land in several shards, retrieve
+        // them, and age them so they get purged.
+        {
+            for (int i = 0; i < 32; ++i)
+                expect (! c.insert (i, std::to_string (i)));
+            expect (c.getCacheSize () == 32);
+            expect (c.getTrackSize () == 32);
+
+            bool found = true;
+            for (int i = 0; i < 32; ++i)
+            {
+                std::string s;
+                found = found && c.retrieve (i, s) && (s == std::to_string (i));
+            }
+            expect (found);
+
+            ++clock;
+            c.sweep ();
+            expect (c.getCacheSize () == 0);
+            expect (c.getTrackSize () == 0);
+        }
+
+        // Hits and misses are combined across the shards.
+        {
+            c.clearStats ();
+            expect (! c.insert (100, "hundred"));
+            expect (c.fetch (100) != nullptr);
+            expect (c.fetch (101) == nullptr);
+            expect (c.getHitRate () == 50.0f);
+
+            ++clock;
+            c.sweep ();
+        }
+
+        // Insert the same key/value pair and make sure we get the same result
+        {
+            expect (! c.insert (3, "three"));
+
+            {
+                Cache::mapped_ptr const p1 (c.fetch (3));
+                Cache::mapped_ptr p2 (std::make_shared <Value> ("three"));
+                c.canonicalize (3, p2);
+                expect (p1.get() == p2.get());
+            }
+            ++clock;
+            c.sweep ();
+            expect (c.getCacheSize() == 0);
+            expect (c.getTrackSize() == 0);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ShardedTaggedCache,common,ripple);
+
+}
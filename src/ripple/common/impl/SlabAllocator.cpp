@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/common/SlabAllocator.h>
+
+#include <beast/unit_test/suite.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace ripple {
+
+class SlabAllocator_test : public beast::unit_test::suite
+{
+public:
+    void testAllocate ()
+    {
+        testcase ("allocate");
+
+        SlabAllocator a (20, 8);
+
+        expect (a.getItemSize () >= 20);
+        expect ((a.getItemSize () % alignof (std::max_align_t)) == 0);
+
+        // Fill several slabs, and check that the blocks don't overlap
+        std::vector <char*> blocks;
+        for (int i = 0; i < 20; ++i)
+        {
+            char* const p (static_cast <char*> (a.allocate ()));
+            std::memset (p, i, 20);
+            blocks.push_back (p);
+        }
+        expect (a.getAllocatedCount () == 20);
+        expect (a.getReservedBytes () == 3 * 8 * a.getItemSize ());
+
+        bool intact (true);
+        for (int i = 0; i < 20; ++i)
+            intact = intact && (std::count (blocks[i], blocks[i] + 20, char (i)) == 20);
+        expect (intact, "blocks overlap");
+
+        std::sort (blocks.begin (), blocks.end ());
+        expect (std::unique (blocks.begin (), blocks.end ()) == blocks.end ());
+
+        // Freed blocks are reused before reserving another slab
+        for (auto p : blocks)
+            a.deallocate (p);
+        expect (a.getAllocatedCount () == 0);
+
+        for (int i = 0; i < 20; ++i)
+            blocks[i] = static_cast <char*> (a.allocate ());
+        expect (a.getReservedBytes () == 3 * 8 * a.getItemSize ());
+
+        for (auto p : blocks)
+            a.deallocate (p);
+    }
+
+    void testThreads ()
+    {
+        testcase ("threads");
+
+        SlabAllocator a (64, 16);
+
+        auto work = [&a] ()
+        {
+            std::vector <void*> blocks;
+            for (int round = 0; round < 100; ++round)
+            {
+                for (int i = 0; i < 50; ++i)
+                    blocks.push_back (a.allocate ());
+                for (auto p : blocks)
+                    a.deallocate (p);
+                blocks.clear ();
+            }
+        };
+
+        std::vector <std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+            threads.emplace_back (work);
+        for (auto& t : threads)
+            t.join ();
+
+        expect (a.getAllocatedCount () == 0);
+        expect (a.getReservedBytes () <= 4 * 50 * a.getItemSize () +
+            16 * a.getItemSize ());
+    }
+
+    void run ()
+    {
+        testAllocate ();
+        testThreads ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SlabAllocator,common,ripple);
+
+}
@@ -799,7 +799,7 @@ public:
     */
     SHAMapAddNode peerGaveNodes (Peer::ptr const& peer
         , uint256 const& setHash, const std::list<SHAMapNode>& nodeIDs
-        , const std::list< Blob >& nodeData)
+        , const std::list<const_byte_view>& nodeData)
     {
         auto acq (mAcquiring.find (setHash));
 
@@ -893,6 +893,8 @@ private:
                 = newLCL->peekTransactionMap ()->disarmDirty ();
 
             // write out dirty nodes (temporarily done here)
+            // Each call holds the map's write lock, so small batches
+            // let readers in between them
             int fc;
 
             while ((fc = newLCL->peekAccountStateMap()->flushDirty (
@@ -954,9 +956,9 @@ private:
                 Blob validation = v->getSigned ();
                 protocol::TMValidation val;
                 val.set_validation (&validation[0], validation.size ());
-                getApp ().overlay ().foreach (send_always (
+                getApp ().overlay ().broadcast (
                     std::make_shared <Message> (
-                        val, protocol::mtVALIDATION)));
+                        val, protocol::mtVALIDATION));
                 WriteLog (lsINFO, LedgerConsensus)
                     << "CNF Val " << newLCLHash;
             }
@@ -1189,9 +1191,9 @@ private:
             msg.set_rawtransaction (& (tx.front ()), tx.size ());
             msg.set_status (protocol::tsNEW);
             msg.set_receivetimestamp (getApp().getOPs ().getNetworkTimeNC ());
-            getApp ().overlay ().foreach (send_always (
+            getApp ().overlay ().broadcast (
                 std::make_shared<Message> (
-                    msg, protocol::mtTRANSACTION)));
+                    msg, protocol::mtTRANSACTION));
         }
     }
 
@@ -1229,9 +1231,9 @@ private:
         Blob sig = mOurPosition->sign ();
         prop.set_nodepubkey (&pubKey[0], pubKey.size ());
         prop.set_signature (&sig[0], sig.size ());
-        getApp ().overlay ().foreach (send_always (
+        getApp ().overlay ().broadcast (
             std::make_shared<Message> (
-                prop, protocol::mtPROPOSE_LEDGER)));
+                prop, protocol::mtPROPOSE_LEDGER));
     }
 
     /** Let peers know that we a particular transactions set so they
@@ -1242,9 +1244,9 @@ private:
         protocol::TMHaveTransactionSet msg;
         msg.set_hash (hash.begin (), 256 / 8);
         msg.set_status (direct ? protocol::tsHAVE : protocol::tsCAN_GET);
-        getApp ().overlay ().foreach (send_always (
+        getApp ().overlay ().broadcast (
             std::make_shared <Message> (
-                msg, protocol::mtHAVE_SET)));
+                msg, protocol::mtHAVE_SET));
     }
 
     /** Apply a set of transactions to a ledger
@@ -1447,9 +1449,9 @@ private:
         }
         s.set_firstseq (uMin);
         s.set_lastseq (uMax);
-        getApp ().overlay ().foreach (send_always (
+        getApp ().overlay ().broadcast (
             std::make_shared <Message> (
-                s, protocol::mtSTATUS_CHANGE)));
+                s, protocol::mtSTATUS_CHANGE));
         WriteLog (lsTRACE, LedgerConsensus) << "send status change to peer";
     }
 
@@ -1742,10 +1744,10 @@ private:
                     closetime
                     nodepubkey
                     signature
-                    getApp ().overlay ().foreach (send_if_not (
+                    getApp ().overlay ().broadcast_if_not (
                         std::make_shared<Message> (
                             set, protocol::mtPROPOSE_LEDGER),
-                                peer_in_set(peers)));
+                                peer_in_set(peers));
                 }
 
     #endif
@@ -72,7 +72,7 @@ public:
     virtual SHAMapAddNode peerGaveNodes (Peer::ptr const& peer, 
         uint256 const & setHash,
         const std::list<SHAMapNode>& nodeIDs, 
-        const std::list< Blob >& nodeData) = 0;
+        const std::list<const_byte_view>& nodeData) = 0;
 
     virtual bool isOurPubKey (const RippleAddress & k) = 0;
 
@@ -19,7 +19,8 @@
 
 namespace ripple {
 
-DatabaseCon::DatabaseCon (const std::string& strName, const char* initStrings[], int initCount)
+DatabaseCon::DatabaseCon (const std::string& strName, const char* initStrings[], int initCount,
+                          int readers)
 {
     // VFALCO TODO remove this dependency on the config by making it the caller's
     //         responsibility to pass in the path. Add a member function to Application
@@ -39,12 +40,85 @@ DatabaseCon::DatabaseCon (const std::string& strName, const char* initStrings[],
 
     for (int i = 0; i < initCount; ++i)
         mDatabase->executeSQL (initStrings[i], true);
+
+    if (useTempFiles)
+        readers = 0;
+
+    for (int i = 0; i < readers; ++i)
+    {
+        Database* db = new SqliteDatabase (pPath.string ().c_str ());
+        db->getSqliteDB ()->connectReadOnly ();
+
+        // Settings such as mmap_size apply per connection
+        for (int j = 0; j < initCount && strncmp (initStrings[j], "PRAGMA ", 7) == 0; ++j)
+            db->executeSQL (initStrings[j], true);
+
+        mReaders.push_back (db);
+    }
+
+    mFreeReaders = mReaders;
 }
 
 DatabaseCon::~DatabaseCon ()
 {
+    assert (mFreeReaders.size () == mReaders.size ());
+
+    for (auto db : mReaders)
+    {
+        db->disconnect ();
+        delete db;
+    }
+
     mDatabase->disconnect ();
     delete mDatabase;
 }
 
+Database* DatabaseCon::acquireReader ()
+{
+    std::lock_guard <std::mutex> lock (mReadLock);
+
+    if (mFreeReaders.empty ())
+        return nullptr;
+
+    Database* db = mFreeReaders.back ();
+    mFreeReaders.pop_back ();
+    return db;
+}
+
+void DatabaseCon::releaseReader (Database* db)
+{
+    std::lock_guard <std::mutex> lock (mReadLock);
+    mFreeReaders.push_back (db);
+}
+
+//------------------------------------------------------------------------------
+
+DatabaseCon::ReadHandle::ReadHandle (DatabaseCon& con)
+    : m_con (&con)
+    , m_db (con.acquireReader ())
+{
+    // Rather than wait for a reader, which could deadlock a caller that
+    // already holds one, share the main connection with the writer.
+    if (m_db == nullptr)
+    {
+        m_lock = std::unique_lock <DeprecatedRecursiveMutex> (con.mLock);
+        m_db = con.mDatabase;
+    }
+}
+
+DatabaseCon::ReadHandle::ReadHandle (ReadHandle&& other)
+    : m_con (other.m_con)
+    , m_db (other.m_db)
+    , m_lock (std::move (other.m_lock))
+{
+    other.m_con = nullptr;
+    other.m_db = nullptr;
+}
+
+DatabaseCon::ReadHandle::~ReadHandle ()
+{
+    if (m_db != nullptr && m_db != m_con->mDatabase)
+        m_con->releaseReader (m_db);
+}
+
 } // ripple
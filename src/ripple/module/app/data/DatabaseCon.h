@@ -27,7 +27,48 @@ namespace ripple {
 class DatabaseCon : beast::LeakChecked <DatabaseCon>
 {
 public:
-    DatabaseCon (const std::string& name, const char* initString[], int countInit);
+    /** Exclusive use of a connection for running queries.
+
+        If a read-only connection is free, the handle takes it from the pool
+        and the query runs without the database lock, so it does not wait
+        for the writer or for other readers. Otherwise the handle uses the
+        main connection and holds the database lock until it is destroyed.
+    */
+    class ReadHandle
+    {
+    public:
+        ReadHandle (ReadHandle&& other);
+        ~ReadHandle ();
+
+        Database* getDB () const
+        {
+            return m_db;
+        }
+
+        Database* operator-> () const
+        {
+            return m_db;
+        }
+
+    private:
+        friend class DatabaseCon;
+
+        explicit ReadHandle (DatabaseCon& con);
+        ReadHandle (ReadHandle const&) = delete;
+        ReadHandle& operator= (ReadHandle const&) = delete;
+
+        DatabaseCon* m_con;
+        Database* m_db;
+        std::unique_lock <DeprecatedRecursiveMutex> m_lock;
+    };
+
+    /** Create the database and run its initialization statements.
+        @param readers The number of extra read-only connections to open.
+                       A temporary database is private to one connection,
+                       so none are opened for it.
+    */
+    DatabaseCon (const std::string& name, const char* initString[], int countInit,
+                 int readers = 0);
     ~DatabaseCon ();
     Database* getDB ()
     {
@@ -38,10 +79,23 @@ public:
         return mLock;
     }
 
+    /** Return a handle for queries which do not modify the database. */
+    ReadHandle getReadDB ()
+    {
+        return ReadHandle (*this);
+    }
+
     // VFALCO TODO change "protected" to "private" throughout the code
 private:
+    Database* acquireReader ();
+    void releaseReader (Database* db);
+
     Database*               mDatabase;
     DeprecatedRecursiveMutex  mLock;
+
+    std::mutex              mReadLock;
+    std::vector <Database*> mReaders;
+    std::vector <Database*> mFreeReaders;
 };
 
 } // ripple
@@ -82,6 +82,19 @@ void SqliteDatabase::connect ()
     }
 }
 
+void SqliteDatabase::connectReadOnly ()
+{
+    int rc = sqlite3_open_v2 (mHost.c_str (), &mConnection,
+                SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX, nullptr);
+
+    if (rc)
+    {
+        WriteLog (lsFATAL, SqliteDatabase) << "Can't read-only open " << mHost << " " << rc;
+        sqlite3_close (mConnection);
+        assert ((rc != SQLITE_BUSY) && (rc != SQLITE_LOCKED));
+    }
+}
+
 sqlite3* SqliteDatabase::getAuxConnection ()
 {
     ScopedLockType sl (m_walMutex);
@@ -109,6 +122,9 @@ sqlite3* SqliteDatabase::getAuxConnection ()
 
 void SqliteDatabase::disconnect ()
 {
+    // Cached statements must be finalized before the connection closes
+    mStatements.clear ();
+
     sqlite3_finalize (mCurrentStmt);
     sqlite3_close (mConnection);
 
@@ -290,6 +306,16 @@ int SqliteDatabase::getKBUsedDB ()
     return cur / 1024;
 }
 
+SqliteStatement& SqliteDatabase::getStatement (std::string const& sql)
+{
+    std::unique_ptr <SqliteStatement>& statement (mStatements[sql]);
+
+    if (! statement)
+        statement.reset (new SqliteStatement (this, sql));
+
+    return *statement;
+}
+
 static int SqliteWALHook (void* s, sqlite3* dbCon, const char* dbName, int walSize)
 {
     (reinterpret_cast<SqliteDatabase*> (s))->doHook (dbName, walSize);
@@ -24,6 +24,8 @@
 
 namespace ripple {
 
+class SqliteStatement;
+
 class SqliteDatabase
     : public Database
     , private beast::Thread
@@ -36,6 +38,12 @@ public:
     void connect ();
     void disconnect ();
 
+    /** Open the connection for queries only.
+        Used for the extra connections which read a WAL database while
+        another connection writes to it.
+    */
+    void connectReadOnly ();
+
     // returns true if the query went ok
     bool executeSQL (const char* sql, bool fail_okay);
 
@@ -71,6 +79,13 @@ public:
         return this;
     }
 
+    /** Return a statement prepared on this connection.
+        The statement is prepared on first use and kept until the connection
+        is closed. The caller must have exclusive use of the connection, and
+        should reset the statement before binding to it.
+    */
+    SqliteStatement& getStatement (std::string const& sql);
+
     void doHook (const char* db, int walSize);
 
     int getKBUsedDB ();
@@ -90,6 +105,8 @@ private:
     sqlite3_stmt* mCurrentStmt;
     bool mMoreRows;
 
+    std::map <std::string, std::unique_ptr <SqliteStatement>> mStatements;
+
     JobQueue*               mWalQ;
     bool                    walRunning;
 };
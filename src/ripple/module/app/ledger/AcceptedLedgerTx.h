@@ -90,6 +90,10 @@ public:
     {
         return mMeta ? mMeta->getIndex () : 0;
     }
+    Blob const& getRawMeta () const
+    {
+        return mRawMeta;
+    }
     std::string getEscMeta () const;
     Json::Value getJson () const
     {
@@ -817,7 +817,7 @@ bool InboundLedger::takeBase (const std::string& data)
     Call with a lock
 */
 bool InboundLedger::takeTxNode (const std::list<SHAMapNode>& nodeIDs,
-    const std::list< Blob >& data, SHAMapAddNode& san)
+    const std::list<const_byte_view>& data, SHAMapAddNode& san)
 {
     if (!mHaveBase)
     {
@@ -834,7 +834,7 @@ bool InboundLedger::takeTxNode (const std::list<SHAMapNode>& nodeIDs,
     }
 
     std::list<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
-    std::list< Blob >::const_iterator nodeDatait = data.begin ();
+    std::list<const_byte_view>::const_iterator nodeDatait = data.begin ();
     TransactionStateSF tFilter (mLedger->getLedgerSeq ());
 
     while (nodeIDit != nodeIDs.end ())
@@ -877,7 +877,7 @@ bool InboundLedger::takeTxNode (const std::list<SHAMapNode>& nodeIDs,
     Call with a lock
 */
 bool InboundLedger::takeAsNode (const std::list<SHAMapNode>& nodeIDs,
-    const std::list< Blob >& data, SHAMapAddNode& san)
+    const std::list<const_byte_view>& data, SHAMapAddNode& san)
 {
     if (m_journal.trace) m_journal.trace <<
         "got ASdata (" << nodeIDs.size () << ") acquiring ledger " << mHash;
@@ -901,7 +901,7 @@ bool InboundLedger::takeAsNode (const std::list<SHAMapNode>& nodeIDs,
     }
 
     std::list<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
-    std::list< Blob >::const_iterator nodeDatait = data.begin ();
+    std::list<const_byte_view>::const_iterator nodeDatait = data.begin ();
     AccountStateSF tFilter (mLedger->getLedgerSeq ());
 
     while (nodeIDit != nodeIDs.end ())
@@ -951,7 +951,7 @@ bool InboundLedger::takeAsNode (const std::list<SHAMapNode>& nodeIDs,
 /** Process AS root node received from a peer
     Call with a lock
 */
-bool InboundLedger::takeAsRootNode (Blob const& data, SHAMapAddNode& san)
+bool InboundLedger::takeAsRootNode (const_byte_view data, SHAMapAddNode& san)
 {
     if (mFailed || mHaveState)
     {
@@ -975,7 +975,7 @@ bool InboundLedger::takeAsRootNode (Blob const& data, SHAMapAddNode& san)
 /** Process AS root node received from a peer
     Call with a lock
 */
-bool InboundLedger::takeTxRootNode (Blob const& data, SHAMapAddNode& san)
+bool InboundLedger::takeTxRootNode (const_byte_view data, SHAMapAddNode& san)
 {
     if (mFailed || mHaveState)
     {
@@ -1094,14 +1094,14 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 
 
         if (!mHaveState && (packet.nodes ().size () > 1) &&
-            !takeAsRootNode (strCopy (packet.nodes (1).nodedata ()), san))
+            !takeAsRootNode (make_byte_view (packet.nodes (1).nodedata ()), san))
         {
             if (m_journal.warning) m_journal.warning <<
                 "Included ASbase invalid";
         }
 
         if (!mHaveTransactions && (packet.nodes ().size () > 2) &&
-            !takeTxRootNode (strCopy (packet.nodes (2).nodedata ()), san))
+            !takeTxRootNode (make_byte_view (packet.nodes (2).nodedata ()), san))
         {
             if (m_journal.warning) m_journal.warning <<
                 "Included TXbase invalid";
@@ -1119,8 +1119,9 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
     if ((packet.type () == protocol::liTX_NODE) || (
         packet.type () == protocol::liAS_NODE))
     {
+        // The node data is viewed in place, the packet outlives this call
         std::list<SHAMapNode> nodeIDs;
-        std::list< Blob > nodeData;
+        std::list<const_byte_view> nodeData;
 
         if (packet.nodes ().size () == 0)
         {
@@ -1144,8 +1145,7 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
 
             nodeIDs.push_back (SHAMapNode (node.nodeid ().data (),
                 node.nodeid ().size ()));
-            nodeData.push_back (Blob (node.nodedata ().begin (),
-                node.nodedata ().end ()));
+            nodeData.push_back (make_byte_view (node.nodedata ()));
         }
 
         SHAMapAddNode ret;
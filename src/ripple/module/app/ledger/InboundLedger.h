@@ -116,17 +116,17 @@ private:
     int processData (std::shared_ptr<Peer> peer, protocol::TMLedgerData& data);
 
     bool takeBase (const std::string& data);
-    bool takeTxNode (const std::list<SHAMapNode>& IDs, const std::list<Blob >& data,
+    bool takeTxNode (const std::list<SHAMapNode>& IDs, const std::list<const_byte_view>& data,
                      SHAMapAddNode&);
-    bool takeTxRootNode (Blob const& data, SHAMapAddNode&);
+    bool takeTxRootNode (const_byte_view data, SHAMapAddNode&);
 
     // VFALCO TODO Rename to receiveAccountStateNode
     //             Don't use acronyms, but if we are going to use them at least
     //             capitalize them correctly.
     //
-    bool takeAsNode (const std::list<SHAMapNode>& IDs, const std::list<Blob >& data,
+    bool takeAsNode (const std::list<SHAMapNode>& IDs, const std::list<const_byte_view>& data,
                      SHAMapAddNode&);
-    bool takeAsRootNode (Blob const& data, SHAMapAddNode&);
+    bool takeAsRootNode (const_byte_view data, SHAMapAddNode&);
 
 private:
     Ledger::pointer    mLedger;
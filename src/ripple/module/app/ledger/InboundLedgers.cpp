@@ -251,7 +251,7 @@ public:
                 Serializer s;
                 SHAMapTreeNode newNode(
                     SHAMapNode (node.nodeid().data(), node.nodeid().size()),
-                    Blob (node.nodedata().begin(), node.nodedata().end()),
+                    make_byte_view (node.nodedata()),
                     0, snfWIRE, uZero, false);
                 newNode.addRaw(s, snfPREFIX);
 
@@ -586,19 +586,143 @@ uint256 Ledger::getHash ()
     return mHash;
 }
 
+// Rows of AccountTransactions written by each multi-row INSERT
+static std::size_t const accountTxRowsPerInsert = 32;
+
+// Most validated ledgers saved in one database transaction
+static std::size_t const ledgersPerSave = 256;
+
+static std::string accountTxInsertSQL (std::size_t rows)
+{
+    std::string sql ("INSERT INTO AccountTransactions "
+                     "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
+
+    for (std::size_t i = 0; i < rows; ++i)
+        sql += (i == 0) ? "(?,?,?,?)" : ",(?,?,?,?)";
+
+    sql += ";";
+    return sql;
+}
+
+static void stepSaveStatement (SqliteStatement& st)
+{
+    int const ret = st.step ();
+
+    if (!st.isDone (ret))
+    {
+        WriteLog (lsWARNING, Ledger) << "Ledger save statement failed: " << st.getError (ret);
+    }
+
+    st.reset ();
+}
+
 bool Ledger::saveValidatedLedger (bool current)
+{
+    return saveValidatedLedgers (SaveList (1, std::make_pair (shared_from_this (), current)));
+}
+
+void Ledger::saveQueuedLedgers (Job&, bool current)
+{
+    // Current and old ledgers wait in separate queues, so that a backlog
+    // of old ledgers never delays saving the current one
+    SaveList& queue = current ? sCurrentSaveQueue : sOldSaveQueue;
+
+    for (;;)
+    {
+        SaveList ledgers;
+
+        {
+            StaticScopedLockType sl (sPendingSaveLock);
+
+            if (queue.empty ())
+            {
+                (current ? sCurrentSaveQueued : sOldSaveQueued) = false;
+                return;
+            }
+
+            if (queue.size () <= ledgersPerSave)
+                ledgers.swap (queue);
+            else
+            {
+                ledgers.assign (queue.begin (), queue.begin () + ledgersPerSave);
+                queue.erase (queue.begin (), queue.begin () + ledgersPerSave);
+            }
+        }
+
+        saveValidatedLedgers (ledgers);
+    }
+}
+
+/** Save a group of validated ledgers with one transaction per database.
+
+    The transactions of every ledger are written first. Then each header
+    row is deleted and added back within a single transaction on the
+    ledger database, so a saved ledger never disappears from the Ledgers
+    table. Until finishSave, the ledgers stay in the pending saves, which
+    tells clients not to trust the database about them yet.
+*/
+bool Ledger::saveValidatedLedgers (SaveList const& ledgers)
+{
+    std::vector <std::pair <Ledger::pointer, std::shared_ptr <AcceptedLedger>>> prepared;
+    prepared.reserve (ledgers.size ());
+
+    for (auto const& it : ledgers)
+    {
+        std::shared_ptr <AcceptedLedger> aLedger (it.first->prepareSave (it.second));
+
+        if (aLedger)
+            prepared.emplace_back (it.first, aLedger);
+    }
+
+    if (!prepared.empty ())
+    {
+        {
+            DatabaseCon* con = getApp().getTxnDB ();
+            DeprecatedScopedLock sl (con->getDBLock ());
+            SqliteDatabase* db = con->getDB ()->getSqliteDB ();
+
+            db->executeSQL ("BEGIN TRANSACTION;", false);
+
+            for (auto const& it : prepared)
+                it.first->saveTransactions (db, *it.second);
+
+            db->executeSQL ("COMMIT TRANSACTION;", false);
+        }
+
+        {
+            DatabaseCon* con = getApp().getLedgerDB ();
+            DeprecatedScopedLock sl (con->getDBLock ());
+            SqliteDatabase* db = con->getDB ()->getSqliteDB ();
+
+            SqliteStatement& deleteLedger (db->getStatement (
+                "DELETE FROM Ledgers WHERE LedgerSeq = ?;"));
+
+            db->executeSQL ("BEGIN TRANSACTION;", false);
+
+            for (auto const& it : prepared)
+            {
+                deleteLedger.bind (1, it.first->getLedgerSeq ());
+                stepSaveStatement (deleteLedger);
+                it.first->saveHeader (db);
+            }
+
+            db->executeSQL ("COMMIT TRANSACTION;", false);
+        }
+
+        for (auto const& it : prepared)
+            it.first->finishSave ();
+    }
+
+    return prepared.size () == ledgers.size ();
+}
+
+/** Check the ledger and store its header in the node store.
+    @return The accepted ledger whose transactions are to be saved, or
+            null if the ledger cannot be saved.
+*/
+std::shared_ptr <AcceptedLedger> Ledger::prepareSave (bool current)
 {
     WriteLog (lsTRACE, Ledger) << "saveValidatedLedger " << (current ? "" : "fromAcquire ") << getLedgerSeq ();
-    static boost::format deleteLedger ("DELETE FROM Ledgers WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans1 ("DELETE FROM Transactions WHERE LedgerSeq = %u;");
-    static boost::format deleteTrans2 ("DELETE FROM AccountTransactions WHERE LedgerSeq = %u;");
-    static boost::format deleteAcctTrans ("DELETE FROM AccountTransactions WHERE TransID = '%s';");
-    static boost::format transExists ("SELECT Status FROM Transactions WHERE TransID = '%s';");
-    static boost::format
-    updateTx ("UPDATE Transactions SET LedgerSeq = %u, Status = '%c', TxnMeta = %s WHERE TransID = '%s';");
-    static boost::format addLedger ("INSERT OR REPLACE INTO Ledgers "
-                                    "(LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,CloseTimeRes,CloseFlags,"
-                                    "AccountSetHash,TransSetHash) VALUES ('%s','%u','%s','%s','%u','%u','%d','%u','%s','%s');");
 
     if (!getAccountHash ().isNonZero ())
     {
@@ -632,103 +756,135 @@ bool Ledger::saveValidatedLedger (bool current)
     {
         WriteLog (lsWARNING, Ledger) << "An accepted ledger was missing nodes";
         getApp().getLedgerMaster().failedSave(mLedgerSeq, mHash);
-        { // Clients can now trust the database for information about this ledger sequence
-            StaticScopedLockType sl (sPendingSaveLock);
-            sPendingSaves.erase(getLedgerSeq());
-        }
-        return false;
+        finishSave ();
+        return AcceptedLedger::pointer ();
     }
 
-    {
-        DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
-        getApp().getLedgerDB ()->getDB ()->executeSQL (boost::str (deleteLedger % mLedgerSeq));
-    }
+    return aLedger;
+}
 
-    {
-        Database* db = getApp().getTxnDB ()->getDB ();
-        DeprecatedScopedLock dbLock (getApp().getTxnDB ()->getDBLock ());
-        db->executeSQL ("BEGIN TRANSACTION;");
+/** Replace this ledger's rows in the transaction database.
+    The caller holds the database lock and has begun a transaction.
+*/
+void Ledger::saveTransactions (SqliteDatabase* db, AcceptedLedger const& aLedger)
+{
+    SqliteStatement& deleteTrans1 (db->getStatement (
+        "DELETE FROM Transactions WHERE LedgerSeq = ?;"));
+    SqliteStatement& deleteTrans2 (db->getStatement (
+        "DELETE FROM AccountTransactions WHERE LedgerSeq = ?;"));
+    SqliteStatement& deleteAcctTrans (db->getStatement (
+        "DELETE FROM AccountTransactions WHERE TransID = ?;"));
+    SqliteStatement& insertTrans (db->getStatement (
+        SerializedTransaction::getMetaSQLInsertReplaceHeader () + "(?,?,?,?,?,?,?,?);"));
+
+    std::uint32_t const ledgerSeq = getLedgerSeq ();
+    std::string const status (1, TXN_SQL_VALIDATED);
 
-        db->executeSQL (boost::str (deleteTrans1 % getLedgerSeq ()));
-        db->executeSQL (boost::str (deleteTrans2 % getLedgerSeq ()));
+    deleteTrans1.bind (1, ledgerSeq);
+    stepSaveStatement (deleteTrans1);
+    deleteTrans2.bind (1, ledgerSeq);
+    stepSaveStatement (deleteTrans2);
 
-        std::string const ledgerSeq (std::to_string (getLedgerSeq ()));
+    // AccountTransactions rows waiting for a multi-row INSERT
+    struct AccountTxRow
+    {
+        std::string txnId;
+        std::string account;
+        std::uint32_t txnSeq;
+    };
+    std::vector <AccountTxRow> accountRows;
+
+    auto insertAccountRows = [&] (std::size_t count)
+    {
+        SqliteStatement& insert (db->getStatement (accountTxInsertSQL (count)));
+        int position = 1;
 
-        for (auto const& vt : aLedger->getMap ())
+        for (std::size_t i = 0; i < count; ++i)
         {
-            uint256 transactionID = vt.second->getTransactionID ();
+            AccountTxRow const& row = accountRows[i];
+            insert.bind (position++, row.txnId);
+            insert.bind (position++, row.account);
+            insert.bind (position++, ledgerSeq);
+            insert.bind (position++, row.txnSeq);
+        }
 
-            getApp().getMasterTransaction ().inLedger (
-                transactionID, getLedgerSeq ());
+        stepSaveStatement (insert);
+        accountRows.erase (accountRows.begin (), accountRows.begin () + count);
+    };
 
-            std::string const txnId (to_string (transactionID));
-            std::string const txnSeq (std::to_string (vt.second->getTxnSeq ()));
+    for (auto const& vt : aLedger.getMap ())
+    {
+        uint256 transactionID = vt.second->getTransactionID ();
 
-            db->executeSQL (boost::str (deleteAcctTrans % transactionID));
+        getApp().getMasterTransaction ().inLedger (transactionID, ledgerSeq);
 
-            auto const& accts = vt.second->getAffected ();
+        std::string const txnId (to_string (transactionID));
 
-            if (!accts.empty ())
-            {
-                std::string sql ("INSERT INTO AccountTransactions "
-                                 "(TransID, Account, LedgerSeq, TxnSeq) VALUES ");
+        deleteAcctTrans.bind (1, txnId);
+        stepSaveStatement (deleteAcctTrans);
 
-                // Try to make an educated guess on how much space we'll need
-                // for our arguments. In argument order we have:
-                // 64 + 34 + 10 + 10 = 118 + 10 extra = 128 bytes
-                sql.reserve (sql.length () + (accts.size () * 128));
+        auto const& accts = vt.second->getAffected ();
 
-                bool first = true;
-                for (auto const& it : accts)
-                {
-                    if (!first)
-                        sql += ", ('";
-                    else
-                    {
-                        sql += "('";
-                        first = false;
-                    }
-
-                    sql += txnId;
-                    sql += "','";
-                    sql += it.humanAccountID ();
-                    sql += "',";
-                    sql += ledgerSeq;
-                    sql += ",";
-                    sql += txnSeq;
-                    sql += ")";
-                }
-                sql += ";";
-                if (ShouldLog (lsTRACE, Ledger))
-                {
-                    WriteLog (lsTRACE, Ledger) << "ActTx: " << sql;
-                }
-                db->executeSQL (sql);
-            }
-            else
-                WriteLog (lsWARNING, Ledger) << "Transaction in ledger " << mLedgerSeq << " affects no accounts";
+        if (accts.empty ())
+        {
+            WriteLog (lsWARNING, Ledger) << "Transaction in ledger " << mLedgerSeq << " affects no accounts";
+        }
+
+        for (auto const& it : accts)
+        {
+            accountRows.push_back (AccountTxRow {txnId, it.humanAccountID (), vt.second->getTxnSeq ()});
 
-            db->executeSQL (SerializedTransaction::getMetaSQLInsertReplaceHeader () +
-                            vt.second->getTxn ()->getMetaSQL (getLedgerSeq (), vt.second->getEscMeta ()) + ";");
+            if (accountRows.size () == accountTxRowsPerInsert)
+                insertAccountRows (accountRows.size ());
         }
-        db->executeSQL ("COMMIT TRANSACTION;");
-    }
 
-    {
-        DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
+        SerializedTransaction::ref txn = vt.second->getTxn ();
+        Serializer rawTxn;
+        txn->add (rawTxn);
+        Blob const& rawMeta = vt.second->getRawMeta ();
 
-        getApp().getLedgerDB ()->getDB ()->executeSQL (boost::str (addLedger %
-                to_string (getHash ()) % mLedgerSeq % to_string (mParentHash) %
-                beast::lexicalCastThrow <std::string> (mTotCoins) % mCloseTime %
-                mParentCloseTime % mCloseResolution % mCloseFlags %
-                to_string (mAccountHash) % to_string (mTransHash)));
+        insertTrans.bind (1, txnId);
+        insertTrans.bind (2, txn->getTransactionType ());
+        insertTrans.bind (3, txn->getSourceAccount ().humanAccountID ());
+        insertTrans.bind (4, txn->getSequence ());
+        insertTrans.bind (5, ledgerSeq);
+        insertTrans.bind (6, status);
+        insertTrans.bindStatic (7, rawTxn.peekData ());
+        insertTrans.bindStatic (8, rawMeta);
+        stepSaveStatement (insertTrans);
     }
 
-    { // Clients can now trust the database for information about this ledger sequence
-        StaticScopedLockType sl (sPendingSaveLock);
-        sPendingSaves.erase(getLedgerSeq());
-    }
-    return true;
+    if (!accountRows.empty ())
+        insertAccountRows (accountRows.size ());
+}
+
+/** Add this ledger's row to the ledger database.
+    The caller holds the database lock and has begun a transaction.
+*/
+void Ledger::saveHeader (SqliteDatabase* db)
+{
+    SqliteStatement& addLedger (db->getStatement ("INSERT OR REPLACE INTO Ledgers "
+        "(LedgerHash,LedgerSeq,PrevHash,TotalCoins,ClosingTime,PrevClosingTime,CloseTimeRes,CloseFlags,"
+        "AccountSetHash,TransSetHash) VALUES (?,?,?,?,?,?,?,?,?,?);"));
+
+    addLedger.bind (1, to_string (getHash ()));
+    addLedger.bind (2, mLedgerSeq);
+    addLedger.bind (3, to_string (mParentHash));
+    addLedger.bind (4, beast::lexicalCastThrow <std::string> (mTotCoins));
+    addLedger.bind (5, mCloseTime);
+    addLedger.bind (6, mParentCloseTime);
+    addLedger.bind (7, static_cast <std::uint32_t> (mCloseResolution));
+    addLedger.bind (8, mCloseFlags);
+    addLedger.bind (9, to_string (mAccountHash));
+    addLedger.bind (10, to_string (mTransHash));
+    stepSaveStatement (addLedger);
+}
+
+void Ledger::finishSave ()
+{
+    // Clients can now trust the database for information about this ledger sequence
+    StaticScopedLockType sl (sPendingSaveLock);
+    sPendingSaves.erase (getLedgerSeq ());
 }
 
 #ifndef NO_SQLITE3_PREPARE
@@ -737,16 +893,17 @@ Ledger::pointer Ledger::loadByIndex (std::uint32_t ledgerIndex)
 {
     Ledger::pointer ledger;
     {
-        Database* db = getApp().getLedgerDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
+        DatabaseCon::ReadHandle db (getApp().getLedgerDB ()->getReadDB ());
 
-        SqliteStatement pSt (db->getSqliteDB (), "SELECT "
+        SqliteStatement& pSt (db->getSqliteDB ()->getStatement ("SELECT "
                              "LedgerHash,PrevHash,AccountSetHash,TransSetHash,TotalCoins,"
                              "ClosingTime,PrevClosingTime,CloseTimeRes,CloseFlags,LedgerSeq"
-                             " from Ledgers WHERE LedgerSeq = ?;");
+                             " from Ledgers WHERE LedgerSeq = ?;"));
 
+        pSt.reset ();
         pSt.bind (1, ledgerIndex);
         ledger = getSQL1 (&pSt);
+        pSt.reset ();
     }
 
     if (ledger)
@@ -762,16 +919,17 @@ Ledger::pointer Ledger::loadByHash (uint256 const& ledgerHash)
 {
     Ledger::pointer ledger;
     {
-        Database* db = getApp().getLedgerDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
+        DatabaseCon::ReadHandle db (getApp().getLedgerDB ()->getReadDB ());
 
-        SqliteStatement pSt (db->getSqliteDB (), "SELECT "
+        SqliteStatement& pSt (db->getSqliteDB ()->getStatement ("SELECT "
                              "LedgerHash,PrevHash,AccountSetHash,TransSetHash,TotalCoins,"
                              "ClosingTime,PrevClosingTime,CloseTimeRes,CloseFlags,LedgerSeq"
-                             " from Ledgers WHERE LedgerHash = ?;");
+                             " from Ledgers WHERE LedgerHash = ?;"));
 
+        pSt.reset ();
         pSt.bind (1, to_string (ledgerHash));
         ledger = getSQL1 (&pSt);
+        pSt.reset ();
     }
 
     if (ledger)
@@ -817,8 +975,7 @@ Ledger::pointer Ledger::getSQL (const std::string& sql)
     std::string hash;
 
     {
-        Database* db = getApp().getLedgerDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
+        DatabaseCon::ReadHandle db (getApp().getLedgerDB ()->getReadDB ());
 
         if (!db->executeSQL (sql) || !db->startIterRows ())
             return Ledger::pointer ();
@@ -936,8 +1093,7 @@ uint256 Ledger::getHashByIndex (std::uint32_t ledgerIndex)
 
     std::string hash;
     {
-        Database* db = getApp().getLedgerDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getLedgerDB ()->getDBLock ());
+        DatabaseCon::ReadHandle db (getApp().getLedgerDB ()->getReadDB ());
 
         if (!db->executeSQL (sql) || !db->startIterRows ())
             return ret;
@@ -954,10 +1110,9 @@ bool Ledger::getHashesByIndex (std::uint32_t ledgerIndex, uint256& ledgerHash, u
 {
 #ifndef NO_SQLITE3_PREPARE
 
-    DatabaseCon* con = getApp().getLedgerDB ();
-    DeprecatedScopedLock sl (con->getDBLock ());
+    DatabaseCon::ReadHandle db (getApp().getLedgerDB ()->getReadDB ());
 
-    SqliteStatement pSt (con->getDB ()->getSqliteDB (),
+    SqliteStatement pSt (db->getSqliteDB (),
                          "SELECT LedgerHash,PrevHash FROM Ledgers INDEXED BY SeqLedger Where LedgerSeq = ?;");
 
     pSt.bind (1, ledgerIndex);
@@ -1022,10 +1177,9 @@ Ledger::getHashesByIndex (std::uint32_t minSeq, std::uint32_t maxSeq)
     sql.append (beast::lexicalCastThrow <std::string> (maxSeq));
     sql.append (";");
 
-    DatabaseCon* con = getApp().getLedgerDB ();
-    DeprecatedScopedLock sl (con->getDBLock ());
+    DatabaseCon::ReadHandle db (getApp().getLedgerDB ()->getReadDB ());
 
-    SqliteStatement pSt (con->getDB ()->getSqliteDB (), sql);
+    SqliteStatement pSt (db->getSqliteDB (), sql);
 
     while (pSt.isRow (pSt.step ()))
     {
@@ -1959,20 +2113,26 @@ bool Ledger::pendSaveValidated (bool isSynchronous, bool isCurrent)
     }
 
     if (isSynchronous)
-    {
         return saveValidatedLedger(isCurrent);
-    }
-    else if (isCurrent)
+
+    // Ledgers which arrive while a save job is waiting are saved with
+    // it, so catching up writes many ledgers per database transaction.
+    bool queueJob;
     {
-        getApp().getJobQueue ().addJob (jtPUBLEDGER, "Ledger::pendSave",
-            std::bind (&Ledger::saveValidatedLedgerAsync, shared_from_this (),
-                       std::placeholders::_1, isCurrent));
+        StaticScopedLockType sl (sPendingSaveLock);
+        (isCurrent ? sCurrentSaveQueue : sOldSaveQueue).emplace_back (
+            shared_from_this (), isCurrent);
+
+        bool& queued = isCurrent ? sCurrentSaveQueued : sOldSaveQueued;
+        queueJob = !queued;
+        queued = true;
     }
-    else
+
+    if (queueJob)
     {
-        getApp().getJobQueue ().addJob (jtPUBOLDLEDGER, "Ledger::pendOldSave",
-            std::bind (&Ledger::saveValidatedLedgerAsync, shared_from_this (),
-                       std::placeholders::_1, isCurrent));
+        getApp().getJobQueue ().addJob (isCurrent ? jtPUBLEDGER : jtPUBOLDLEDGER,
+            isCurrent ? "Ledger::pendSave" : "Ledger::pendOldSave",
+            std::bind (&Ledger::saveQueuedLedgers, std::placeholders::_1, isCurrent));
     }
 
     return true;
@@ -2113,5 +2273,9 @@ BEAST_DEFINE_TESTSUITE(Ledger,ripple_app,ripple);
 
 Ledger::StaticLockType Ledger::sPendingSaveLock;
 std::set<std::uint32_t> Ledger::sPendingSaves;
+Ledger::SaveList Ledger::sCurrentSaveQueue;
+Ledger::SaveList Ledger::sOldSaveQueue;
+bool Ledger::sCurrentSaveQueued = false;
+bool Ledger::sOldSaveQueued = false;
 
 } // ripple
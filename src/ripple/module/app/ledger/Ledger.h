@@ -23,6 +23,8 @@
 namespace ripple {
 
 class Job;
+class AcceptedLedger;
+class SqliteDatabase;
 
 enum LedgerStateParms
 {
@@ -485,12 +487,20 @@ protected:
     // returned SLE is immutable
     SLE::pointer getASNodeI (uint256 const & nodeID, LedgerEntryType let);
 
-    void saveValidatedLedgerAsync(Job&, bool current)
-    {
-        saveValidatedLedger(current);
-    }
     bool saveValidatedLedger (bool current);
 
+private:
+    typedef std::vector <std::pair <Ledger::pointer, bool>> SaveList;
+
+    static void saveQueuedLedgers (Job&, bool current);
+    static bool saveValidatedLedgers (SaveList const& ledgers);
+    std::shared_ptr <AcceptedLedger> prepareSave (bool current);
+    void saveTransactions (SqliteDatabase* db, AcceptedLedger const& aLedger);
+    void saveHeader (SqliteDatabase* db);
+    void finishSave ();
+
+protected:
+
     void updateFees ();
 
 private:
@@ -523,6 +533,13 @@ private:
     static StaticLockType sPendingSaveLock;
 
     static std::set<std::uint32_t>  sPendingSaves;
+
+    // validated ledgers waiting to be saved together at each priority, and
+    // whether a job to save them is queued
+    static SaveList sCurrentSaveQueue;
+    static SaveList sOldSaveQueue;
+    static bool sCurrentSaveQueued;
+    static bool sOldSaveQueued;
 };
 
 inline LedgerStateParms operator| (const LedgerStateParms& l1, const LedgerStateParms& l2)
@@ -32,6 +32,7 @@ void LedgerEntrySet::init (Ledger::ref ledger, uint256 const& transactionID,
                            std::uint32_t ledgerID, TransactionEngineParams params)
 {
     mEntries.clear ();
+    mBase.reset ();
     mLedger = ledger;
     mSet.init (transactionID, ledgerID);
     mParams = params;
@@ -41,18 +42,44 @@ void LedgerEntrySet::init (Ledger::ref ledger, uint256 const& transactionID,
 void LedgerEntrySet::clear ()
 {
     mEntries.clear ();
+    mBase.reset ();
     mSet.clear ();
 }
 
+LedgerEntrySet::LedgerEntrySet (const LedgerEntrySet& e)
+    : mLedger (e.mLedger)
+    , mSet (e.mSet)
+    , mParams (e.mParams)
+    , mSeq (e.mSeq)
+    , mImmutable (e.mImmutable)
+{
+    e.freeze ();
+    mBase = e.mBase;
+}
+
+LedgerEntrySet& LedgerEntrySet::operator= (const LedgerEntrySet& e)
+{
+    if (this != &e)
+    {
+        setTo (e);
+        mImmutable = e.mImmutable;
+    }
+
+    return *this;
+}
+
 LedgerEntrySet LedgerEntrySet::duplicate () const
 {
-    return LedgerEntrySet (mLedger, mEntries, mSet, mSeq + 1);
+    freeze ();
+    return LedgerEntrySet (mLedger, mBase, mSet, mSeq + 1);
 }
 
 void LedgerEntrySet::setTo (const LedgerEntrySet& e)
 {
+    e.freeze ();
     mLedger = e.mLedger;
-    mEntries = e.mEntries;
+    mEntries.clear ();
+    mBase = e.mBase;
     mSet = e.mSet;
     mParams = e.mParams;
     mSeq = e.mSeq;
@@ -62,16 +89,128 @@ void LedgerEntrySet::swapWith (LedgerEntrySet& e)
 {
     std::swap (mLedger, e.mLedger);
     mEntries.swap (e.mEntries);
+    mBase.swap (e.mBase);
     mSet.swap (e.mSet);
     std::swap (mParams, e.mParams);
     std::swap (mSeq, e.mSeq);
 }
 
+// Move the entries touched since the last checkpoint into a new shared
+// layer, so that copies of this set can share them.
+void LedgerEntrySet::freeze () const
+{
+    if (mEntries.empty ())
+        return;
+
+    if (mBase && (mBase->depth >= maxLayerDepth))
+        flatten ();
+
+    auto layer = std::make_shared<Layer> ();
+    layer->entries.swap (mEntries);
+    layer->parent = mBase;
+    layer->depth = mBase ? (mBase->depth + 1) : 1;
+    mBase = layer;
+}
+
+// Merge the shared layers into this set's own entries. Entries already
+// present, or present in a higher layer, take precedence.
+void LedgerEntrySet::flatten () const
+{
+    for (auto layer = mBase.get (); layer != nullptr; layer = layer->parent.get ())
+        mEntries.insert (layer->entries.begin (), layer->entries.end ());
+
+    mBase.reset ();
+}
+
+// Find an entry, copying it out of the shared layers if needed so that
+// this set can change it. The copy shares the SLE until getEntry copies it.
+LedgerEntrySet::EntryMap::iterator LedgerEntrySet::find (uint256 const& index)
+{
+    auto it = mEntries.find (index);
+
+    if ((it != mEntries.end ()) || !mBase)
+        return it;
+
+    for (auto layer = mBase.get (); layer != nullptr; layer = layer->parent.get ())
+    {
+        auto const found = layer->entries.find (index);
+
+        if (found != layer->entries.end ())
+            return mEntries.insert (*found).first;
+    }
+
+    return mEntries.end ();
+}
+
+// Find the current version of an entry without taking a copy of it
+LedgerEntrySetEntry const* LedgerEntrySet::peek (uint256 const& index) const
+{
+    auto const it = mEntries.find (index);
+
+    if (it != mEntries.end ())
+        return &it->second;
+
+    for (auto layer = mBase.get (); layer != nullptr; layer = layer->parent.get ())
+    {
+        auto const found = layer->entries.find (index);
+
+        if (found != layer->entries.end ())
+            return &found->second;
+    }
+
+    return nullptr;
+}
+
+bool LedgerEntrySet::isLayered (uint256 const& index) const
+{
+    for (auto layer = mBase.get (); layer != nullptr; layer = layer->parent.get ())
+    {
+        if (layer->entries.count (index) != 0)
+            return true;
+    }
+
+    return false;
+}
+
+// Advance index to the next entry in the set, in any layer, and return
+// the current version of that entry.
+bool LedgerEntrySet::nextEntry (uint256& index, LedgerEntrySetEntry const*& entry) const
+{
+    bool found = false;
+    uint256 next;
+
+    auto it = mEntries.upper_bound (index);
+
+    if (it != mEntries.end ())
+    {
+        next = it->first;
+        found = true;
+    }
+
+    for (auto layer = mBase.get (); layer != nullptr; layer = layer->parent.get ())
+    {
+        auto const lit = layer->entries.upper_bound (index);
+
+        if ((lit != layer->entries.end ()) && (!found || (lit->first < next)))
+        {
+            next = lit->first;
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    index = next;
+    entry = peek (next);
+    return true;
+}
+
 // Find an entry in the set.  If it has the wrong sequence number, copy it and update the sequence number.
 // This is basically: copy-on-read.
 SLE::pointer LedgerEntrySet::getEntry (uint256 const& index, LedgerEntryAction& action)
 {
-    auto it = mEntries.find (index);
+    auto it = find (index);
 
     if (it == mEntries.end ())
     {
@@ -125,19 +264,19 @@ SLE::pointer LedgerEntrySet::entryCache (LedgerEntryType letType, uint256 const&
 
 LedgerEntryAction LedgerEntrySet::hasEntry (uint256 const& index) const
 {
-    std::map<uint256, LedgerEntrySetEntry>::const_iterator it = mEntries.find (index);
+    LedgerEntrySetEntry const* entry = peek (index);
 
-    if (it == mEntries.end ())
+    if (entry == nullptr)
         return taaNONE;
 
-    return it->second.mAction;
+    return entry->mAction;
 }
 
 void LedgerEntrySet::entryCache (SLE::ref sle)
 {
     assert (mLedger);
     assert (sle->isMutable () || mImmutable); // Don't put an immutable SLE in a mutable LES
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = find (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
@@ -162,7 +301,7 @@ void LedgerEntrySet::entryCreate (SLE::ref sle)
 {
     assert (mLedger && !mImmutable);
     assert (sle->isMutable ());
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = find (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
@@ -200,7 +339,7 @@ void LedgerEntrySet::entryModify (SLE::ref sle)
 {
     assert (sle->isMutable () && !mImmutable);
     assert (mLedger);
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = find (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
@@ -236,7 +375,7 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
 {
     assert (sle->isMutable () && !mImmutable);
     assert (mLedger);
-    auto it = mEntries.find (sle->getIndex ());
+    auto it = find (sle->getIndex ());
 
     if (it == mEntries.end ())
     {
@@ -258,6 +397,14 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
         break;
 
     case taaCREATE:
+        if (isLayered (it->first))
+        {
+            // The erase must not uncover the entry in a shared layer
+            uint256 const index = it->first;
+            flatten ();
+            it = mEntries.find (index);
+        }
+
         mEntries.erase (it);
         break;
 
@@ -271,6 +418,8 @@ void LedgerEntrySet::entryDelete (SLE::ref sle)
 
 bool LedgerEntrySet::hasChanges ()
 {
+    flatten ();
+
     for (auto const& it : mEntries)
         if (it.second.mAction != taaCACHED)
             return true;
@@ -284,6 +433,8 @@ Json::Value LedgerEntrySet::getJson (int) const
 
     Json::Value nodes (Json::arrayValue);
 
+    flatten ();
+
     for (auto it = mEntries.begin (), end = mEntries.end (); it != end; ++it)
     {
         Json::Value entry (Json::objectValue);
@@ -358,7 +509,7 @@ Json::Value LedgerEntrySet::getJson (int) const
 SLE::pointer LedgerEntrySet::getForMod (uint256 const& node, Ledger::ref ledger,
                                         ripple::unordered_map<uint256, SLE::pointer>& newMods)
 {
-    auto it = mEntries.find (node);
+    auto it = find (node);
 
     if (it != mEntries.end ())
     {
@@ -465,6 +616,8 @@ void LedgerEntrySet::calcRawMeta (Serializer& s, TER result, std::uint32_t index
     // Entries modified only as a result of building the transaction metadata
     ripple::unordered_map<uint256, SLE::pointer> newMod;
 
+    flatten ();
+
     for (auto& it : mEntries)
     {
         SField::ptr type = &sfGeneric;
@@ -1013,21 +1166,23 @@ uint256 LedgerEntrySet::getNextLedgerIndex (uint256 const& uHash)
 {
     // find next node in ledger that isn't deleted by LES
     uint256 ledgerNext = uHash;
-    std::map<uint256, LedgerEntrySetEntry>::const_iterator it;
+    LedgerEntrySetEntry const* entry;
 
     do
     {
         ledgerNext = mLedger->getNextLedgerIndex (ledgerNext);
-        it  = mEntries.find (ledgerNext);
+        entry = peek (ledgerNext);
     }
-    while ((it != mEntries.end ()) && (it->second.mAction == taaDELETE));
+    while ((entry != nullptr) && (entry->mAction == taaDELETE));
 
     // find next node in LES that isn't deleted
-    for (it = mEntries.upper_bound (uHash); it != mEntries.end (); ++it)
+    uint256 lesNext = uHash;
+
+    while (nextEntry (lesNext, entry))
     {
         // node found in LES, node found in ledger, return earliest
-        if (it->second.mAction != taaDELETE)
-            return (ledgerNext.isNonZero () && (ledgerNext < it->first)) ? ledgerNext : it->first;
+        if (entry->mAction != taaDELETE)
+            return (ledgerNext.isNonZero () && (ledgerNext < lesNext)) ? ledgerNext : lesNext;
     }
 
     // nothing next in LES, return next ledger node
@@ -72,6 +72,11 @@ public:
     (because it's cheaper, can be checkpointed, and so on). When the
     transaction finishes, the LES is committed into the ledger to make
     the modifications. The transaction metadata is built from the LES too.
+
+    Checkpoints are cheap: copying or duplicating a set moves its entries
+    into an immutable layer shared by both sets, and each set then records
+    only the entries it touches afterwards. Discarding a checkpoint
+    discards just those entries. Iterating a set merges its layers first.
 */
 class LedgerEntrySet
     : public CountedObject <LedgerEntrySet>
@@ -88,6 +93,10 @@ public:
     {
     }
 
+    LedgerEntrySet (const LedgerEntrySet&);
+
+    LedgerEntrySet& operator= (const LedgerEntrySet&);
+
     // set functions
     void setImmutable ()
     {
@@ -230,22 +239,26 @@ public:
     typedef std::map<uint256, LedgerEntrySetEntry>::const_iterator          const_iterator;
     bool isEmpty () const
     {
-        return mEntries.empty ();
+        return mEntries.empty () && !mBase;
     }
     std::map<uint256, LedgerEntrySetEntry>::const_iterator begin () const
     {
+        flatten ();
         return mEntries.begin ();
     }
     std::map<uint256, LedgerEntrySetEntry>::const_iterator end () const
     {
+        flatten ();
         return mEntries.end ();
     }
     std::map<uint256, LedgerEntrySetEntry>::iterator begin ()
     {
+        flatten ();
         return mEntries.begin ();
     }
     std::map<uint256, LedgerEntrySetEntry>::iterator end ()
     {
+        flatten ();
         return mEntries.end ();
     }
 
@@ -255,20 +268,50 @@ public:
     }
 
 private:
+    typedef std::map<uint256, LedgerEntrySetEntry> EntryMap; // cannot be unordered!
+
+    // Entries shared by the sets checkpointed from a common set
+    struct Layer
+    {
+        EntryMap entries;
+        std::shared_ptr<Layer const> parent;
+        int depth;
+    };
+
+    // Layers deeper than this are merged when the next checkpoint is made
+    enum
+    {
+        maxLayerDepth = 8
+    };
+
     Ledger::pointer mLedger;
-    std::map<uint256, LedgerEntrySetEntry>  mEntries; // cannot be unordered!
+
+    // Entries touched since the last checkpoint, and the shared layers
+    // below them. Copying a set freezes the entries into a new layer,
+    // which changes the representation but not the contents.
+    mutable EntryMap mEntries;
+    mutable std::shared_ptr<Layer const> mBase;
+
     TransactionMetaSet mSet;
     TransactionEngineParams mParams;
     int mSeq;
     bool mImmutable;
 
-    LedgerEntrySet (Ledger::ref ledger, const std::map<uint256, LedgerEntrySetEntry>& e,
+    LedgerEntrySet (Ledger::ref ledger, std::shared_ptr<Layer const> const& base,
                     const TransactionMetaSet & s, int m) :
-        mLedger (ledger), mEntries (e), mSet (s), mParams (tapNONE), mSeq (m), mImmutable (false)
+        mLedger (ledger), mBase (base), mSet (s), mParams (tapNONE), mSeq (m), mImmutable (false)
     {
         ;
     }
 
+    void freeze () const;
+    void flatten () const;
+
+    EntryMap::iterator find (uint256 const& index);
+    LedgerEntrySetEntry const* peek (uint256 const& index) const;
+    bool isLayered (uint256 const& index) const;
+    bool nextEntry (uint256& index, LedgerEntrySetEntry const*& entry) const;
+
     SLE::pointer getForMod (uint256 const & node, Ledger::ref ledger,
                             ripple::unordered_map<uint256, SLE::pointer>& newMods);
 
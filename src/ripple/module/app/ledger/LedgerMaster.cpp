@@ -1002,6 +1002,7 @@ public:
 
                         setFullLedger(ledger, true, true);
                         getApp().getOPs().pubLedger(ledger);
+                        getApp().getOrderBookDB().setup(ledger);
                     }
 
                     setPubLedger(ledger);
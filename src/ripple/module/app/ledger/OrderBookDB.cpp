@@ -24,6 +24,7 @@ SETUP_LOG (OrderBookDB)
 OrderBookDB::OrderBookDB (Stoppable& parent)
     : Stoppable ("OrderBookDB", parent)
     , mSeq (0)
+    , mUpdateSeq (0)
 {
 
 }
@@ -39,20 +40,33 @@ void OrderBookDB::setup (Ledger::ref ledger)
     {
         ScopedLockType sl (mLock);
 
-        // Do a full update every 256 ledgers
+        // Follow the next ledger from its metadata, fall back to a full
+        // update if a ledger was missed
         if (mSeq != 0)
         {
             if (ledger->getLedgerSeq () == mSeq)
                 return;
-            if ((ledger->getLedgerSeq () > mSeq) && ((ledger->getLedgerSeq () - mSeq) < 256))
-                return;
+
             if ((ledger->getLedgerSeq () < mSeq) && ((mSeq - ledger->getLedgerSeq ()) < 16))
                 return;
+
+            if (ledger->getLedgerSeq () == (mSeq + 1))
+            {
+                mSeq = ledger->getLedgerSeq ();
+
+                if (mUpdateSeq != 0)
+                    mPending.push_back (ledger);
+                else
+                    applyLedger (ledger);
+                return;
+            }
         }
 
         WriteLog (lsDEBUG, OrderBookDB) << "Advancing from " << mSeq << " to " << ledger->getLedgerSeq();
 
         mSeq = ledger->getLedgerSeq ();
+        mUpdateSeq = mSeq;
+        mPending.clear ();
     }
 
     if (getConfig().RUN_STANDALONE)
@@ -116,7 +130,12 @@ void OrderBookDB::update (Ledger::pointer ledger)
     {
         WriteLog (lsINFO, OrderBookDB) << "OrderBookDB::update encountered a missing node";
         ScopedLockType sl (mLock);
-        mSeq = 0;
+        if (mUpdateSeq == ledger->getLedgerSeq ())
+        {
+            mSeq = 0;
+            mUpdateSeq = 0;
+            mPending.clear ();
+        }
         return;
     }
 
@@ -124,13 +143,111 @@ void OrderBookDB::update (Ledger::pointer ledger)
     {
         ScopedLockType sl (mLock);
 
+        if (mUpdateSeq != ledger->getLedgerSeq ())
+        {
+            // A later full update replaced this one
+            return;
+        }
+
         mXRPBooks.swap(XRPBooks);
         mSourceMap.swap(sourceMap);
         mDestMap.swap(destMap);
+
+        mUpdateSeq = 0;
+
+        // Catch up with the ledgers published while we were working
+        for (auto const& pending : mPending)
+            applyLedger (pending);
+        mPending.clear ();
     }
     getApp().getLedgerMaster().newOrderBookDB();
 }
 
+static uint160 getBookField (STObject const& fields, SField::ref field)
+{
+    // Created nodes omit fields holding default values, such as XRP
+    if (!fields.isFieldPresent (field))
+        return uint160 ();
+    return fields.getFieldH160 (field);
+}
+
+// Track the books created and deleted by a ledger which follows the one the
+// books reflect. The caller must hold the lock.
+void OrderBookDB::applyLedger (Ledger::ref ledger)
+{
+    AcceptedLedger::pointer accepted (AcceptedLedger::makeAcceptedLedger (ledger));
+    int created = 0;
+    int deleted = 0;
+
+    try
+    {
+        for (auto const& item : accepted->getMap ())
+        {
+            TransactionMetaSet::pointer meta = item.second->getMeta ();
+
+            if (!meta)
+                continue;
+
+            for (auto const& node : meta->getNodes ())
+            {
+                if (node.getFieldU16 (sfLedgerEntryType) != ltDIR_NODE)
+                    continue;
+
+                bool const isCreated = node.getFName () == sfCreatedNode;
+
+                if (!isCreated && (node.getFName () != sfDeletedNode))
+                    continue;
+
+                const STObject* fields = dynamic_cast<const STObject*> (
+                    node.peekAtPField (isCreated ? sfNewFields : sfFinalFields));
+
+                // Only the first page of a quality directory describes a book
+                if (!fields ||
+                    !fields->isFieldPresent (sfRootIndex) ||
+                    (fields->getFieldH256 (sfRootIndex) != node.getFieldH256 (sfLedgerIndex)) ||
+                    !(fields->isFieldPresent (sfExchangeRate) ||
+                      fields->isFieldPresent (sfTakerPaysCurrency) ||
+                      fields->isFieldPresent (sfTakerGetsCurrency)))
+                    continue;
+
+                uint160 const ci = getBookField (*fields, sfTakerPaysCurrency);
+                uint160 const co = getBookField (*fields, sfTakerGetsCurrency);
+                uint160 const ii = getBookField (*fields, sfTakerPaysIssuer);
+                uint160 const io = getBookField (*fields, sfTakerGetsIssuer);
+
+                if (isCreated)
+                {
+                    addOrderBook (ci, co, ii, io);
+                    ++created;
+                    continue;
+                }
+
+                // The book remains while any of its quality directories do
+                uint256 const index = Ledger::getBookBase (ci, ii, co, io);
+
+                if (ledger->getNextLedgerIndex (index, Ledger::getQualityNext (index)).isZero ())
+                {
+                    removeOrderBook (index, ci, co, ii, io);
+                    ++deleted;
+                }
+            }
+        }
+    }
+    catch (const SHAMapMissingNode&)
+    {
+        WriteLog (lsINFO, OrderBookDB) << "OrderBookDB::applyLedger encountered a missing node";
+        mSeq = 0;
+        return;
+    }
+
+    if (created || deleted)
+    {
+        WriteLog (lsDEBUG, OrderBookDB) << "OrderBookDB::applyLedger " <<
+            ledger->getLedgerSeq () << ": " << created << " quality directories created, " <<
+            deleted << " books deleted";
+    }
+}
+
 void OrderBookDB::addOrderBook(const uint160& ci, const uint160& co,
     const uint160& ii, const uint160& io)
 {
@@ -164,6 +281,42 @@ void OrderBookDB::addOrderBook(const uint160& ci, const uint160& co,
         mXRPBooks.insert(RippleAssetRef (ci, ii));
 }
 
+void OrderBookDB::removeOrderBook (uint256 const& index,
+    const uint160& ci, const uint160& co,
+    const uint160& ii, const uint160& io)
+{
+    ScopedLockType sl (mLock);
+
+    auto const isBook = [&index] (OrderBook::ref book)
+    {
+        return book->getBookBase () == index;
+    };
+
+    auto const source = mSourceMap.find (RippleAssetRef (ci, ii));
+
+    if (source != mSourceMap.end ())
+    {
+        std::vector <OrderBook::pointer>& books (source->second);
+        books.erase (std::remove_if (books.begin (), books.end (), isBook), books.end ());
+        if (books.empty ())
+            mSourceMap.erase (source);
+    }
+
+    auto const dest = mDestMap.find (RippleAssetRef (co, io));
+
+    if (dest != mDestMap.end ())
+    {
+        std::vector <OrderBook::pointer>& books (dest->second);
+        books.erase (std::remove_if (books.begin (), books.end (), isBook), books.end ());
+        if (books.empty ())
+            mDestMap.erase (dest);
+    }
+
+    // There is only one book from an asset to XRP
+    if (co.isZero ())
+        mXRPBooks.erase (RippleAssetRef (ci, ii));
+}
+
 // return list of all orderbooks that want this issuerID and currencyID
 void OrderBookDB::getBooksByTakerPays (RippleIssuer const& issuerID, RippleCurrency const& currencyID,
                                        std::vector<OrderBook::pointer>& bookRet)
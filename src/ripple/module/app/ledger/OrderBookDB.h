@@ -78,6 +78,12 @@ public:
     void processTxn (Ledger::ref ledger, const AcceptedLedgerTx& alTx, Json::Value const& jvObj);
 
 private:
+    void applyLedger (Ledger::ref ledger);
+
+    void removeOrderBook (uint256 const& index,
+        const uint160& takerPaysCurrency, const uint160& takerGetsCurrency,
+        const uint160& takerPaysIssuer, const uint160& takerGetsIssuer);
+
     // by ci/ii
     ripple::unordered_map <RippleAsset,
         std::vector <OrderBook::pointer>> mSourceMap;
@@ -97,8 +103,15 @@ private:
 
     MapType mListeners;
 
+    // The ledger the books reflect, zero if a full update is needed
     std::uint32_t mSeq;
 
+    // The ledger a full update is running for, zero if none is
+    std::uint32_t mUpdateSeq;
+
+    // Ledgers which followed mUpdateSeq, applied when the full update ends
+    std::vector <Ledger::pointer> mPending;
+
 };
 
 } // ripple
@@ -0,0 +1,290 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <beast/unit_test/suite.h>
+
+namespace ripple {
+
+class LedgerEntrySet_test : public beast::unit_test::suite
+{
+public:
+    typedef std::vector <int> Indexes;
+
+    // Small indexes sort before every entry of the genesis ledger
+    static uint256 makeIndex (int i)
+    {
+        uint256 index;
+        index.end ()[-1] = static_cast <unsigned char> (i);
+        return index;
+    }
+
+    // A ledger holding directory nodes 1, 3 and 5, each with value i
+    static Ledger::pointer makeLedger ()
+    {
+        RippleAddress const seed (RippleAddress::createSeedGeneric ("masterpassphrase"));
+        RippleAddress const generator (RippleAddress::createGeneratorPublic (seed));
+        RippleAddress const root (RippleAddress::createAccountPublic (generator, 0));
+
+        Ledger::pointer ledger (std::make_shared <Ledger> (root, SYSTEM_CURRENCY_START));
+
+        for (int i : {1, 3, 5})
+        {
+            SLE::pointer sle (std::make_shared <SLE> (ltDIR_NODE, makeIndex (i)));
+            sle->setFieldU64 (sfIndexNext, i);
+            ledger->writeBack (lepCREATE, sle);
+        }
+
+        return ledger;
+    }
+
+    static void init (LedgerEntrySet& les, Ledger::ref ledger)
+    {
+        les.init (ledger, uint256 (), ledger->getLedgerSeq (), tapNONE);
+    }
+
+    // The value of an entry, or zero if the set has no such entry
+    static std::uint64_t value (LedgerEntrySet& les, int i)
+    {
+        SLE::pointer sle (les.entryCache (ltDIR_NODE, makeIndex (i)));
+        return sle ? sle->getFieldU64 (sfIndexNext) : 0;
+    }
+
+    static void create (LedgerEntrySet& les, int i, std::uint64_t v)
+    {
+        SLE::pointer sle (les.entryCreate (ltDIR_NODE, makeIndex (i)));
+        sle->setFieldU64 (sfIndexNext, v);
+    }
+
+    static void modify (LedgerEntrySet& les, int i, std::uint64_t v)
+    {
+        SLE::pointer sle (les.entryCache (ltDIR_NODE, makeIndex (i)));
+        sle->setFieldU64 (sfIndexNext, v);
+        les.entryModify (sle);
+    }
+
+    static void erase (LedgerEntrySet& les, int i)
+    {
+        les.entryDelete (les.entryCache (ltDIR_NODE, makeIndex (i)));
+    }
+
+    // The entries getNextLedgerIndex visits, in order
+    static Indexes walk (LedgerEntrySet& les)
+    {
+        Indexes indexes;
+        uint256 const end (makeIndex (0x7f));
+        uint256 index;
+
+        while ((index = les.getNextLedgerIndex (index, end)).isNonZero ())
+            indexes.push_back (index.end ()[-1]);
+
+        return indexes;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void testRollback ()
+    {
+        testcase ("rollback");
+
+        Ledger::pointer ledger (makeLedger ());
+
+        LedgerEntrySet les;
+        init (les, ledger);
+        modify (les, 1, 10);
+        create (les, 2, 20);
+
+        LedgerEntrySet const checkpoint = les;
+
+        LedgerEntrySet work (checkpoint.duplicate ());
+        modify (work, 1, 11);
+        modify (work, 2, 21);
+        erase (work, 3);
+        create (work, 4, 40);
+
+        expect (value (work, 1) == 11, "work: modify");
+        expect (value (work, 2) == 21, "work: modify created");
+        expect (value (work, 3) == 0, "work: delete");
+        expect (value (work, 4) == 40, "work: create");
+
+        // The checkpoint and the set it was copied from are unchanged
+        expect (value (les, 1) == 10, "source changed");
+        expect (value (les, 2) == 20, "source changed");
+        expect (value (les, 3) == 3, "source changed");
+        expect (les.hasEntry (makeIndex (4)) == taaNONE, "source changed");
+
+        // Roll back
+        work.setTo (checkpoint);
+        expect (value (work, 1) == 10, "rollback: modify");
+        expect (value (work, 2) == 20, "rollback: modify created");
+        expect (value (work, 3) == 3, "rollback: delete");
+        expect (work.hasEntry (makeIndex (4)) == taaNONE, "rollback: create");
+
+        // Commit
+        LedgerEntrySet next (checkpoint.duplicate ());
+        modify (next, 1, 12);
+        les.swapWith (next);
+        expect (value (les, 1) == 12, "commit");
+        expect (value (next, 1) == 10, "commit");
+
+        // A long chain of checkpoints, deep enough to be merged
+        std::vector <LedgerEntrySet> chain (1, les);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            chain.push_back (chain.back ().duplicate ());
+            modify (chain.back (), 1, 100 + i);
+        }
+
+        for (int i = 0; i < 20; ++i)
+            expect (value (chain [i + 1], 1) == 100 + i, "chain");
+
+        expect (value (chain.front (), 1) == 12, "chain start");
+    }
+
+    void testDeleteCreated ()
+    {
+        testcase ("delete created");
+
+        Ledger::pointer ledger (makeLedger ());
+
+        LedgerEntrySet les;
+        init (les, ledger);
+        create (les, 2, 20);
+
+        // The created entry is only in a shared layer of work
+        LedgerEntrySet work (les.duplicate ());
+        erase (work, 2);
+
+        expect (work.hasEntry (makeIndex (2)) == taaNONE, "deleted create kept");
+        expect (!work.entryCache (ltDIR_NODE, makeIndex (2)), "deleted create visible");
+        expect (walk (work) == Indexes ({1, 3, 5}), "deleted create walked");
+
+        int entries = 0;
+        for (auto const& it : work)
+        {
+            if (it.first == makeIndex (2))
+                ++entries;
+        }
+        expect (entries == 0, "deleted create iterated");
+
+        expect (les.hasEntry (makeIndex (2)) == taaCREATE, "source lost create");
+        expect (value (les, 2) == 20, "source lost create");
+
+        // Created in one layer, modified in another, deleted in a third
+        LedgerEntrySet first (les.duplicate ());
+        modify (first, 2, 21);
+        LedgerEntrySet second (first.duplicate ());
+        erase (second, 2);
+
+        expect (second.hasEntry (makeIndex (2)) == taaNONE, "deleted create kept");
+        expect (value (first, 2) == 21, "layer changed");
+        expect (value (les, 2) == 20, "layer changed");
+    }
+
+    void testNextIndex ()
+    {
+        testcase ("next index");
+
+        Ledger::pointer ledger (makeLedger ());
+
+        LedgerEntrySet les;
+        init (les, ledger);
+        create (les, 2, 20);
+
+        LedgerEntrySet first (les.duplicate ());
+        erase (first, 3);
+        create (first, 6, 60);
+
+        LedgerEntrySet second (first.duplicate ());
+        create (second, 4, 40);
+        erase (second, 5);
+
+        // No changes of its own, so every entry is in a shared layer
+        LedgerEntrySet third (second.duplicate ());
+
+        // The same changes made without checkpoints
+        LedgerEntrySet flat;
+        init (flat, ledger);
+        create (flat, 2, 20);
+        erase (flat, 3);
+        create (flat, 6, 60);
+        create (flat, 4, 40);
+        erase (flat, 5);
+
+        expect (walk (les) == Indexes ({1, 2, 3, 5}), "walk source");
+        expect (walk (first) == Indexes ({1, 2, 5, 6}), "walk first");
+        expect (walk (second) == Indexes ({1, 2, 4, 6}), "walk second");
+        expect (walk (third) == Indexes ({1, 2, 4, 6}), "walk third");
+        expect (walk (third) == walk (flat), "walk differs from flat");
+    }
+
+    void testMeta ()
+    {
+        testcase ("metadata");
+
+        Ledger::pointer ledger (makeLedger ());
+
+        LedgerEntrySet layered;
+        init (layered, ledger);
+        modify (layered, 1, 10);
+        create (layered, 2, 20);
+
+        LedgerEntrySet first (layered.duplicate ());
+        erase (first, 3);
+        create (first, 4, 40);
+        modify (first, 2, 21);
+
+        LedgerEntrySet second (first.duplicate ());
+        modify (second, 1, 11);
+        erase (second, 4);
+        modify (second, 5, 50);
+
+        LedgerEntrySet flat;
+        init (flat, ledger);
+        modify (flat, 1, 10);
+        create (flat, 2, 20);
+        erase (flat, 3);
+        create (flat, 4, 40);
+        modify (flat, 2, 21);
+        modify (flat, 1, 11);
+        erase (flat, 4);
+        modify (flat, 5, 50);
+
+        Serializer layeredMeta;
+        second.calcRawMeta (layeredMeta, tesSUCCESS, 0);
+
+        Serializer flatMeta;
+        flat.calcRawMeta (flatMeta, tesSUCCESS, 0);
+
+        expect (layeredMeta.peekData () == flatMeta.peekData (),
+            "metadata differs from flat");
+    }
+
+    void run ()
+    {
+        testRollback ();
+        testDeleteCreated ();
+        testNextIndex ();
+        testMeta ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerEntrySet,ripple_app,ripple);
+
+} // ripple
@@ -213,6 +213,7 @@ public:
     std::unique_ptr <AmendmentTable> m_amendmentTable;
     std::unique_ptr <LoadFeeTrack> mFeeTrack;
     std::unique_ptr <IHashRouter> mHashRouter;
+    std::unique_ptr <SigVerifier> m_sigVerifier;
     std::unique_ptr <Validations> mValidations;
     std::unique_ptr <ProofOfWorkFactory> mProofOfWorkFactory;
     std::unique_ptr <LoadManager> m_loadManager;
@@ -279,7 +280,7 @@ public:
             "full_below", get_seconds_clock (), m_collectorManager->collector (),
                 fullBelowTargetSize, fullBelowExpirationSeconds))
 
-        , m_nodeStoreScheduler (*this)
+        , m_nodeStoreScheduler (*this, m_collectorManager->group ("nodestore"))
 
         // The JobQueue has to come pretty early since
         // almost everything is a Stoppable child of the JobQueue.
@@ -347,6 +348,9 @@ public:
 
         , mHashRouter (IHashRouter::New (IHashRouter::getDefaultHoldTime ()))
 
+        , m_sigVerifier (make_SigVerifier (*m_jobQueue, *mHashRouter,
+            LogPartition::getJournal <NetworkOPsLog> ()))
+
         , mValidations (Validations::New ())
 
         , mProofOfWorkFactory (ProofOfWorkFactory::New ())
@@ -383,12 +387,20 @@ public:
         // VFALCO HACK
         m_nodeStoreScheduler.setJobQueue (*m_jobQueue);
 
+        PublicKeyCache::setCollector (m_collectorManager->group ("pubkey_cache"));
+
         add (m_ledgerMaster->getPropertySource ());
 
         // VFALCO TODO remove these once the call is thread safe.
         HashMaps::getInstance ().initializeNonce <size_t> ();
     }
 
+    ~ApplicationImp ()
+    {
+        // The cache outlives us, so detach it from our collector
+        PublicKeyCache::setCollector (nullptr);
+    }
+
     //--------------------------------------------------------------------------
 
     CollectorManager& getCollectorManager ()
@@ -483,6 +495,11 @@ public:
         return *m_txQueue;
     }
 
+    SigVerifier& getSigVerifier ()
+    {
+        return *m_sigVerifier;
+    }
+
     OrderBookDB& getOrderBookDB ()
     {
         return m_orderBookDB;
@@ -574,9 +591,10 @@ public:
 
     static DatabaseCon* openDatabaseCon (const char* fileName,
                                          const char* dbInit[],
-                                         int dbCount)
+                                         int dbCount,
+                                         int readers = 0)
     {
-        return new DatabaseCon (fileName, dbInit, dbCount);
+        return new DatabaseCon (fileName, dbInit, dbCount, readers);
     }
 
     void initSqliteDb (int index)
@@ -584,8 +602,10 @@ public:
         switch (index)
         {
         case 0: mRpcDB.reset (openDatabaseCon ("rpc.db", RpcDBInit, RpcDBCount)); break;
-        case 1: mTxnDB.reset (openDatabaseCon ("transaction.db", TxnDBInit, TxnDBCount)); break;
-        case 2: mLedgerDB.reset (openDatabaseCon ("ledger.db", LedgerDBInit, LedgerDBCount)); break;
+        // The transaction and ledger databases serve tx, account_tx and
+        // ledger lookups, so they get read-only connections for those.
+        case 1: mTxnDB.reset (openDatabaseCon ("transaction.db", TxnDBInit, TxnDBCount, 4)); break;
+        case 2: mLedgerDB.reset (openDatabaseCon ("ledger.db", LedgerDBInit, LedgerDBCount, 4)); break;
         case 3: mWalletDB.reset (openDatabaseCon ("wallet.db", WalletDBInit, WalletDBCount)); break;
         };
     }
@@ -745,7 +765,8 @@ public:
         //             if (!getConfig ().RUN_STANDALONE)
         m_peers = make_Overlay (m_mainIoPool, *m_resourceManager,
             *m_siteFiles, getConfig ().getModuleDatabasePath (),
-            *m_resolver, m_mainIoPool, m_peerSSLContext->get ());
+            *m_resolver, m_mainIoPool, m_peerSSLContext->get (),
+                m_collectorManager->group ("overlay"));
         // add to Stoppable
         add (*m_peers);
 
@@ -1095,6 +1116,9 @@ public:
         logTimedCall (m_journal.warning, "SHAMap::sweep", __FILE__, __LINE__,
             &SHAMap::sweep);
 
+        logTimedCall (m_journal.warning, "PublicKeyCache::sweep", __FILE__, __LINE__,
+            &PublicKeyCache::sweep);
+
         logTimedCall (m_journal.warning, "NetworkOPs::sweepFetchPack", __FILE__, __LINE__, boost::bind (
             &NetworkOPs::sweepFetchPack, m_networkOPs.get ()));
 
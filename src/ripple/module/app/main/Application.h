@@ -47,6 +47,7 @@ class ProofOfWorkFactory;
 class SerializedLedgerEntry;
 class TransactionMaster;
 class TxQueue;
+class SigVerifier;
 class LocalCredentials;
 class PathRequests;
 
@@ -103,6 +104,7 @@ public:
     virtual OrderBookDB&            getOrderBookDB () = 0;
     virtual TransactionMaster&      getMasterTransaction () = 0;
     virtual TxQueue&                getTxQueue () = 0;
+    virtual SigVerifier&            getSigVerifier () = 0;
     virtual LocalCredentials&       getLocalCredentials () = 0;
     virtual Resource::Manager&      getResourceManager () = 0;
     virtual PathRequests&           getPathRequests () = 0;
@@ -213,11 +213,20 @@ public:
             // VFALCO TODO Eliminate the dependence on the Application object.
             //             Choices include constructing with the job queue / feetracker.
             //             Another option is using an observer pattern to invert the dependency.
+            // A node store falling behind on writes is overloaded too,
+            // well before it has to make storing threads wait.
+            int const writeLoad = getApp().getNodeStore ().getWriteLoad ();
+
             if (getApp().getJobQueue ().isOverloaded ())
             {
                 m_journal.info << getApp().getJobQueue ().getJson (0);
                 change = getApp().getFeeTrack ().raiseLocalFee ();
             }
+            else if (writeLoad >= (NodeStore::batchWriteLimit / 2))
+            {
+                m_journal.info << "Write load " << writeLoad;
+                change = getApp().getFeeTrack ().raiseLocalFee ();
+            }
             else
             {
                 change = getApp().getFeeTrack ().lowerLocalFee ();
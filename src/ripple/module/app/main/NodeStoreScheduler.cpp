@@ -19,10 +19,14 @@
 
 namespace ripple {
 
-NodeStoreScheduler::NodeStoreScheduler (Stoppable& parent)
+NodeStoreScheduler::NodeStoreScheduler (Stoppable& parent,
+    beast::insight::Collector::ptr const& collector)
     : Stoppable ("NodeStoreScheduler", parent)
     , m_jobQueue (nullptr)
     , m_taskCount (0)
+    , m_writeLatency (collector->make_event ("write_latency"))
+    , m_writeQueued (collector->make_event ("write_queued"))
+    , m_writePending (collector->make_gauge ("write_pending"))
 {
 }
 
@@ -63,13 +67,17 @@ void NodeStoreScheduler::onFetch (NodeStore::FetchReport const& report)
     if (report.wentToDisk)
         m_jobQueue->addLoadEvents (
             report.isAsync ? jtNS_ASYNC_READ : jtNS_SYNC_READ,
-                1, report.elapsed);
+                report.fetchCount, report.elapsed);
 }
 
 void NodeStoreScheduler::onBatchWrite (NodeStore::BatchWriteReport const& report)
 {
     m_jobQueue->addLoadEvents (jtNS_WRITE,
         report.writeCount, report.elapsed);
+
+    m_writeLatency.notify (report.elapsed);
+    m_writeQueued.notify (report.queued);
+    m_writePending.set (report.pending);
 }
 
 } // ripple
@@ -28,7 +28,8 @@ class NodeStoreScheduler
     , public beast::Stoppable
 {
 public:
-    NodeStoreScheduler (Stoppable& parent);
+    NodeStoreScheduler (Stoppable& parent,
+        beast::insight::Collector::ptr const& collector);
 
     // VFALCO NOTE This is a temporary hack to solve the problem
     //             of circular dependency.
@@ -46,6 +47,9 @@ private:
 
     JobQueue* m_jobQueue;
     std::atomic <int> m_taskCount;
+    beast::insight::Event m_writeLatency;
+    beast::insight::Event m_writeQueued;
+    beast::insight::Gauge m_writePending;
 };
 
 } // ripple
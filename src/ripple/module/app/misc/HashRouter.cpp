@@ -17,6 +17,8 @@
 */
 //==============================================================================
 
+#include <beast/unit_test/suite.h>
+
 namespace ripple {
 
 // VFALCO TODO Inline the function definitions
@@ -35,20 +37,20 @@ private:
         {
         }
 
-        std::set <PeerShortID> const& peekPeers () const
+        std::vector <PeerShortID> const& peekPeers () const
         {
             return mPeers;
         }
 
         void addPeer (PeerShortID peer)
         {
-            if (peer != 0)
-                mPeers.insert (peer);
+            if ((peer != 0) && ! hasPeer (peer))
+                mPeers.push_back (peer);
         }
-        
+
         bool hasPeer (PeerShortID peer) const
         {
-            return mPeers.count (peer) > 0;
+            return std::find (mPeers.begin (), mPeers.end (), peer) != mPeers.end ();
         }
 
         int getFlags (void) const
@@ -73,18 +75,61 @@ private:
 
         void swapSet (std::set <PeerShortID>& other)
         {
-            mPeers.swap (other);
+            std::vector <PeerShortID> peers (other.begin (), other.end ());
+            other.clear ();
+            other.insert (mPeers.begin (), mPeers.end ());
+            mPeers.swap (peers);
         }
 
     private:
         int mFlags;
-        std::set <PeerShortID> mPeers;
+
+        // Few peers relay any one hash, so a flat vector beats a tree
+        std::vector <PeerShortID> mPeers;
+    };
+
+    /** A partition of the routing table with its own lock.
+
+        Entries expire through a ring of one-second buckets. Each bucket
+        holds the hashes created during one second, and is emptied when
+        the ring comes back around to it, holdTime seconds later.
+    */
+    class Shard
+    {
+    public:
+        typedef RippleMutex LockType;
+        typedef std::lock_guard <LockType> ScopedLockType;
+
+        explicit Shard (int holdTime)
+            : mBuckets (std::max (1, holdTime))
+            , mLastTime (UptimeTimer::getInstance ().getElapsedSeconds ())
+        {
+        }
+
+        Entry& findCreateEntry (uint256 const& index, bool& created);
+
+        LockType mLock;
+
+    private:
+        void expire (int now);
+
+        ripple::unordered_map <uint256, Entry> mSuppressionMap;
+        std::vector <std::vector <uint256>> mBuckets;
+        int mLastTime;
+    };
+
+    enum
+    {
+        // Must be a power of two
+        shardCount = 16
     };
 
 public:
     explicit HashRouter (int holdTime)
-        : mHoldTime (holdTime)
     {
+        mShards.reserve (shardCount);
+        for (int i = 0; i < shardCount; ++i)
+            mShards.emplace_back (new Shard (holdTime));
     }
 
     bool addSuppression (uint256 const& index);
@@ -98,27 +143,45 @@ public:
     bool swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag);
 
 private:
-    Entry getEntry (uint256 const& );
+    Shard& getShard (uint256 const& index)
+    {
+        // The index is itself a hash, so any of its bytes will do
+        return *mShards [*index.begin () & (shardCount - 1)];
+    }
 
-    Entry& findCreateEntry (uint256 const& , bool& created);
+    std::vector <std::unique_ptr <Shard>> mShards;
+};
 
-    typedef RippleMutex LockType;
-    typedef std::lock_guard <LockType> ScopedLockType;
-    LockType mLock;
+//------------------------------------------------------------------------------
 
-    // Stores all suppressed hashes and their expiration time
-    ripple::unordered_map <uint256, Entry> mSuppressionMap;
+void HashRouter::Shard::expire (int now)
+{
+    int const size = mBuckets.size ();
 
-    // Stores all expiration times and the hashes indexed for them
-    std::map< int, std::list<uint256> > mSuppressionTimes;
+    if ((now - mLastTime) >= size)
+        mLastTime = now - size;
 
-    int mHoldTime;
-};
+    // Empty the bucket of each second that has come around again
+    while (mLastTime < now)
+    {
+        ++mLastTime;
 
-//------------------------------------------------------------------------------
+        std::vector <uint256>& bucket = mBuckets [mLastTime % size];
+
+        for (auto const& index : bucket)
+            mSuppressionMap.erase (index);
+
+        bucket.clear ();
+    }
+}
 
-HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& created)
+HashRouter::Entry& HashRouter::Shard::findCreateEntry (uint256 const& index, bool& created)
 {
+    int const now = UptimeTimer::getInstance ().getElapsedSeconds ();
+
+    if (now != mLastTime)
+        expire (now);
+
     ripple::unordered_map<uint256, Entry>::iterator fit = mSuppressionMap.find (index);
 
     if (fit != mSuppressionMap.end ())
@@ -129,55 +192,39 @@ HashRouter::Entry& HashRouter::findCreateEntry (uint256 const& index, bool& crea
 
     created = true;
 
-    int now = UptimeTimer::getInstance ().getElapsedSeconds ();
-    int expireTime = now - mHoldTime;
-
-    // See if any supressions need to be expired
-    std::map< int, std::list<uint256> >::iterator it = mSuppressionTimes.begin ();
-
-    if ((it != mSuppressionTimes.end ()) && (it->first <= expireTime))
-    {
-        BOOST_FOREACH (uint256 const & lit, it->second)
-        mSuppressionMap.erase (lit);
-        mSuppressionTimes.erase (it);
-    }
-
-    mSuppressionTimes[now].push_back (index);
+    mBuckets [now % mBuckets.size ()].push_back (index);
     return mSuppressionMap.emplace (index, Entry ()).first->second;
 }
 
+//------------------------------------------------------------------------------
+
 bool HashRouter::addSuppression (uint256 const& index)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    Shard::ScopedLockType sl (shard.mLock);
 
     bool created;
-    findCreateEntry (index, created);
+    shard.findCreateEntry (index, created);
     return created;
 }
 
-HashRouter::Entry HashRouter::getEntry (uint256 const& index)
-{
-    ScopedLockType sl (mLock);
-
-    bool created;
-    return findCreateEntry (index, created);
-}
-
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    Shard::ScopedLockType sl (shard.mLock);
 
     bool created;
-    findCreateEntry (index, created).addPeer (peer);
+    shard.findCreateEntry (index, created).addPeer (peer);
     return created;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer, int& flags)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    Shard::ScopedLockType sl (shard.mLock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = shard.findCreateEntry (index, created);
     s.addPeer (peer);
     flags = s.getFlags ();
     return created;
@@ -185,18 +232,20 @@ bool HashRouter::addSuppressionPeer (uint256 const& index, PeerShortID peer, int
 
 int HashRouter::getFlags (uint256 const& index)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    Shard::ScopedLockType sl (shard.mLock);
 
     bool created;
-    return findCreateEntry (index, created).getFlags ();
+    return shard.findCreateEntry (index, created).getFlags ();
 }
 
 bool HashRouter::addSuppressionFlags (uint256 const& index, int flag)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    Shard::ScopedLockType sl (shard.mLock);
 
     bool created;
-    findCreateEntry (index, created).setFlag (flag);
+    shard.findCreateEntry (index, created).setFlag (flag);
     return created;
 }
 
@@ -209,10 +258,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
     // return: true = changed, false = unchanged
     assert (flag != 0);
 
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    Shard::ScopedLockType sl (shard.mLock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = shard.findCreateEntry (index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
@@ -223,10 +273,11 @@ bool HashRouter::setFlag (uint256 const& index, int flag)
 
 bool HashRouter::swapSet (uint256 const& index, std::set<PeerShortID>& peers, int flag)
 {
-    ScopedLockType sl (mLock);
+    Shard& shard = getShard (index);
+    Shard::ScopedLockType sl (shard.mLock);
 
     bool created;
-    Entry& s = findCreateEntry (index, created);
+    Entry& s = shard.findCreateEntry (index, created);
 
     if ((s.getFlags () & flag) == flag)
         return false;
@@ -242,5 +293,52 @@ IHashRouter* IHashRouter::New (int holdTime)
     return new HashRouter (holdTime);
 }
 
-} // ripple
+//------------------------------------------------------------------------------
 
+class HashRouter_test : public beast::unit_test::suite
+{
+public:
+    void testFlags ()
+    {
+        HashRouter router (IHashRouter::getDefaultHoldTime ());
+        uint256 const a (1);
+        uint256 const b (2);
+
+        expect (router.addSuppression (a), "new hash not created");
+        expect (! router.addSuppression (a), "known hash created again");
+
+        expect (router.setFlag (a, SF_SIGGOOD), "flag not set");
+        expect (! router.setFlag (a, SF_SIGGOOD), "flag set twice");
+        expect (router.getFlags (a) == SF_SIGGOOD, "wrong flags");
+        expect (router.getFlags (b) == 0, "flags leaked between hashes");
+    }
+
+    void testPeers ()
+    {
+        HashRouter router (IHashRouter::getDefaultHoldTime ());
+        uint256 const a (3);
+        int flags;
+
+        expect (router.addSuppressionPeer (a, 5, flags), "new hash not created");
+        expect (! router.addSuppressionPeer (a, 7, flags), "known hash created again");
+        expect (! router.addSuppressionPeer (a, 5, flags), "known hash created again");
+
+        std::set <IHashRouter::PeerShortID> peers;
+        peers.insert (9);
+        expect (router.swapSet (a, peers, SF_RELAYED), "set not swapped");
+        expect (peers.size () == 2 && peers.count (5) && peers.count (7),
+            "wrong peers returned");
+
+        expect (! router.swapSet (a, peers, SF_RELAYED), "relayed twice");
+    }
+
+    void run ()
+    {
+        testFlags ();
+        testPeers ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(HashRouter,ripple_app,ripple);
+
+} // ripple
@@ -31,6 +31,7 @@ namespace ripple {
 #define SF_SAVED        0x08
 #define SF_RETRY        0x10    // Transaction can be retried
 #define SF_TRUSTED      0x20    // comes from trusted source
+#define SF_SIGBAD       0x40    // Signature was checked and is bad
 
 /** Routing table for objects identified by hash.
 
@@ -235,7 +235,7 @@ public:
     void processTrustedProposal (LedgerProposal::pointer proposal, std::shared_ptr<protocol::TMProposeSet> set,
                                  RippleAddress nodePublic, uint256 checkLedger, bool sigGood);
     SHAMapAddNode gotTXData (const std::shared_ptr<Peer>& peer, uint256 const& hash,
-                             const std::list<SHAMapNode>& nodeIDs, const std::list< Blob >& nodeData);
+                             const std::list<SHAMapNode>& nodeIDs, const std::list<const_byte_view>& nodeData);
     bool recvValidation (SerializedValidation::ref val, const std::string& source);
     void takePosition (int seq, SHAMap::ref position);
     SHAMap::pointer getTXMap (uint256 const& hash);
@@ -378,6 +378,23 @@ public:
 
     std::vector<RippleAddress> getLedgerAffectedAccounts (std::uint32_t ledgerSeq);
 
+private:
+    // A row of an account's transaction history, copied out of the database
+    struct AccountTxRow
+    {
+        std::uint32_t ledgerSeq;
+        std::uint32_t txnSeq;
+        std::string status;
+        Blob rawTxn;
+        Blob rawMeta;
+    };
+
+    bool getAccountTxRows (const RippleAddress& account, std::int32_t minLedger,
+                           std::int32_t maxLedger, bool forward, Json::Value& token,
+                           std::uint32_t numberOfResults, std::vector<AccountTxRow>& rows);
+
+public:
+
     //
     // Monitoring: publisher side
     //
@@ -627,9 +644,9 @@ void NetworkOPsImp::processClusterTimer ()
         node.set_name (to_string (item.address));
         node.set_cost (item.balance);
     }
-    getApp ().overlay ().foreach (send_if (
+    getApp ().overlay ().broadcast_if (
         std::make_shared<Message>(cluster, protocol::mtCLUSTER),
-        peer_in_cluster ()));
+        peer_in_cluster ());
     setClusterTimer ();
 }
 
@@ -902,9 +919,9 @@ void NetworkOPsImp::runTransactionQueue ()
                         tx.set_rawtransaction (&s.getData ().front (), s.getLength ());
                         tx.set_status (protocol::tsCURRENT);
                         tx.set_receivetimestamp (getNetworkTimeNC ()); // FIXME: This should be when we received it
-                        getApp ().overlay ().foreach (send_if_not (
+                        getApp ().overlay ().broadcast_if_not (
                             std::make_shared<Message> (tx, protocol::mtTRANSACTION),
-                            peer_in_set(peers)));
+                            peer_in_set(peers));
                     }
                     else
                         m_journal.debug << "recently relayed";
@@ -1033,9 +1050,9 @@ Transaction::pointer NetworkOPsImp::processTransactionCb (
                 tx.set_rawtransaction (&s.getData ().front (), s.getLength ());
                 tx.set_status (protocol::tsCURRENT);
                 tx.set_receivetimestamp (getNetworkTimeNC ()); // FIXME: This should be when we received it
-                getApp ().overlay ().foreach (send_if_not (
+                getApp ().overlay ().broadcast_if_not (
                     std::make_shared<Message> (tx, protocol::mtTRANSACTION),
-                    peer_in_set(peers)));
+                    peer_in_set(peers));
             }
         }
     }
@@ -1443,8 +1460,8 @@ void NetworkOPsImp::switchLastClosedLedger (Ledger::pointer newLedger, bool duri
     hash = newLedger->getHash ();
     s.set_ledgerhash (hash.begin (), hash.size ());
 
-    getApp ().overlay ().foreach (send_always (
-        std::make_shared<Message> (s, protocol::mtSTATUS_CHANGE)));
+    getApp ().overlay ().broadcast (
+        std::make_shared<Message> (s, protocol::mtSTATUS_CHANGE));
 }
 
 int NetworkOPsImp::beginConsensus (uint256 const& networkClosed, Ledger::pointer closingLedger)
@@ -1562,9 +1579,9 @@ void NetworkOPsImp::processTrustedProposal (LedgerProposal::pointer proposal,
             if (getApp().getHashRouter ().swapSet (
                 proposal->getSuppressionID (), peers, SF_RELAYED))
 	    {
-                getApp ().overlay ().foreach (send_if_not (
+                getApp ().overlay ().broadcast_if_not (
                     std::make_shared<Message> (*set, protocol::mtPROPOSE_LEDGER),
-                    peer_in_set(peers)));
+                    peer_in_set(peers));
 	    }
         }
         else
@@ -1612,7 +1629,7 @@ void NetworkOPsImp::takePosition (int seq, SHAMap::ref position)
 
 // Call with the master lock for now
 SHAMapAddNode NetworkOPsImp::gotTXData (const std::shared_ptr<Peer>& peer, uint256 const& hash,
-                                     const std::list<SHAMapNode>& nodeIDs, const std::list< Blob >& nodeData)
+                                     const std::list<SHAMapNode>& nodeIDs, const std::list<const_byte_view>& nodeData)
 {
 
     if (!mConsensus)
@@ -1820,8 +1837,8 @@ NetworkOPsImp::getAccountTxs (const RippleAddress& account, std::int32_t minLedg
                       minLedger, maxLedger, descending, offset, limit, false, false, bAdmin);
 
     {
-        Database* db = getApp().getTxnDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
+        DatabaseCon::ReadHandle handle (getApp().getTxnDB ()->getReadDB ());
+        Database* db = handle.getDB ();
 
         SQL_FOREACH (db, sql)
         {
@@ -1870,8 +1887,8 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
                       minLedger, maxLedger, descending, offset, limit, true/*binary*/, false, bAdmin);
 
     {
-        Database* db = getApp().getTxnDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
+        DatabaseCon::ReadHandle handle (getApp().getTxnDB ()->getReadDB ());
+        Database* db = handle.getDB ();
 
         SQL_FOREACH (db, sql)
         {
@@ -1911,40 +1928,39 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
 }
 
 
-std::vector< std::pair<Transaction::pointer, TransactionMetaSet::pointer> >
-NetworkOPsImp::getTxsAccount (const RippleAddress& account, std::int32_t minLedger,
-                              std::int32_t maxLedger, bool forward, Json::Value& token,
-                              int limit, bool bAdmin)
-{
-    std::vector< std::pair<Transaction::pointer, TransactionMetaSet::pointer> > ret;
+/** Read one page of an account's transactions, resuming at the marker.
 
-    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
-    std::uint32_t EXTRA_LENGTH = 20;
+    The marker names the (LedgerSeq, TxnSeq) of the first row to return, so
+    the query seeks straight to it instead of skipping earlier rows. Rows are
+    copied out as raw blobs, and the caller decodes them after the database
+    lock is released. If more rows follow, the token is set to the next one.
 
-    bool foundResume = token.isNull() || !token.isObject();
+    @return `false` if the token is malformed.
+*/
+bool
+NetworkOPsImp::getAccountTxRows (const RippleAddress& account, std::int32_t minLedger,
+                                 std::int32_t maxLedger, bool forward, Json::Value& token,
+                                 std::uint32_t numberOfResults, std::vector<AccountTxRow>& rows)
+{
+    std::uint32_t findLedger, findSeq;
 
-    std::uint32_t numberOfResults, queryLimit;
-    if (limit <= 0)
-        numberOfResults = NONBINARY_PAGE_LENGTH;
-    else if (!bAdmin && (limit > NONBINARY_PAGE_LENGTH))
-        numberOfResults = NONBINARY_PAGE_LENGTH;
+    if (token.isNull () || !token.isObject ())
+    {
+        findLedger = forward ? 0 : std::numeric_limits<std::uint32_t>::max ();
+        findSeq = findLedger;
+    }
     else
-        numberOfResults = limit;
-    queryLimit = numberOfResults + 1 + (foundResume ? 0 : EXTRA_LENGTH);
-
-    std::uint32_t findLedger = 0, findSeq = 0;
-    if (!foundResume)
     {
         try
         {
             if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return ret;
-            findLedger = token[jss::ledger].asInt();
-            findSeq = token[jss::seq].asInt();
+                return false;
+            findLedger = token[jss::ledger].asUInt();
+            findSeq = token[jss::seq].asUInt();
         }
         catch (...)
         {
-            return ret;
+            return false;
         }
     }
 
@@ -1952,70 +1968,130 @@ NetworkOPsImp::getTxsAccount (const RippleAddress& account, std::int32_t minLedg
     //         outputs, so we need to clear it in between.
     token = Json::nullValue;
 
-    std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
-         "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
-         "WHERE AccountTransactions.Account = '%s' AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
-         "ORDER BY AccountTransactions.LedgerSeq %s, AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
-         "LIMIT %u;")
-             % account.humanAccountID()
-             % ((forward && (findLedger != 0)) ? findLedger : minLedger)
-             % ((!forward && (findLedger != 0)) ? findLedger: maxLedger)
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % queryLimit);
-    {
-        Database* db = getApp().getTxnDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
+    std::uint32_t lowLedger = static_cast<std::uint32_t> (minLedger);
+    std::uint32_t highLedger = static_cast<std::uint32_t> (maxLedger);
 
-        SQL_FOREACH (db, sql)
+    if (forward)
+        lowLedger = std::max (lowLedger, findLedger);
+    else
+        highLedger = std::min (highLedger, findLedger);
+
+    rows.reserve (numberOfResults + 1);
+
+    {
+        DatabaseCon::ReadHandle db (getApp().getTxnDB ()->getReadDB ());
+
+        // These are prepared once per connection and reused
+        static char const* const sqlForward =
+            "SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
+            "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
+            "WHERE AccountTransactions.Account = ?1 AND AccountTransactions.LedgerSeq BETWEEN ?2 AND ?3 "
+            "AND (AccountTransactions.LedgerSeq > ?4 OR "
+            "(AccountTransactions.LedgerSeq = ?4 AND AccountTransactions.TxnSeq >= ?5)) "
+            "ORDER BY AccountTransactions.LedgerSeq ASC, AccountTransactions.TxnSeq ASC, AccountTransactions.TransID ASC "
+            "LIMIT ?6;";
+
+        static char const* const sqlBackward =
+            "SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
+            "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
+            "WHERE AccountTransactions.Account = ?1 AND AccountTransactions.LedgerSeq BETWEEN ?2 AND ?3 "
+            "AND (AccountTransactions.LedgerSeq < ?4 OR "
+            "(AccountTransactions.LedgerSeq = ?4 AND AccountTransactions.TxnSeq <= ?5)) "
+            "ORDER BY AccountTransactions.LedgerSeq DESC, AccountTransactions.TxnSeq DESC, AccountTransactions.TransID DESC "
+            "LIMIT ?6;";
+
+        SqliteStatement& pSt = db->getSqliteDB ()->getStatement (
+            forward ? sqlForward : sqlBackward);
+
+        pSt.reset ();
+        pSt.bind (1, account.humanAccountID ());
+        pSt.bind (2, lowLedger);
+        pSt.bind (3, highLedger);
+        pSt.bind (4, findLedger);
+        pSt.bind (5, findSeq);
+        pSt.bind (6, numberOfResults + 1);
+
+        for (;;)
         {
-            if (!foundResume)
+            int const iRet = pSt.step ();
+
+            if (!pSt.isRow (iRet))
             {
-                if ((findLedger == db->getInt("LedgerSeq")) && (findSeq == db->getInt("TxnSeq")))
-                    foundResume = true;
+                if (!pSt.isDone (iRet))
+                    m_journal.warning << "account_tx query failed: " << pSt.getError (iRet);
+                break;
             }
-            else if (numberOfResults == 0)
+
+            if (rows.size () == numberOfResults)
             {
                 token = Json::objectValue;
-                token[jss::ledger] = db->getInt("LedgerSeq");
-                token[jss::seq] = db->getInt("TxnSeq");
+                token[jss::ledger] = pSt.getUInt32 (0);
+                token[jss::seq] = pSt.getUInt32 (1);
                 break;
             }
 
-            if (foundResume)
-            {
-                Transaction::pointer txn = Transaction::transactionFromSQL (db, false);
+            rows.emplace_back ();
+            AccountTxRow& row = rows.back ();
+            row.ledgerSeq = pSt.getUInt32 (0);
+            row.txnSeq = pSt.getUInt32 (1);
+            row.status = pSt.getString (2);
 
-                Serializer rawMeta;
-                int metaSize = 2048;
-                rawMeta.resize (metaSize);
-                metaSize = db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
+            unsigned char const* const rawTxn =
+                static_cast <unsigned char const*> (pSt.peekBlob (3));
+            row.rawTxn.assign (rawTxn, rawTxn + pSt.size (3));
 
-                if (metaSize > rawMeta.getLength ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-                }
-                else
-                    rawMeta.resize (metaSize);
-
-                if (rawMeta.getLength() == 0)
-                { // Work around a bug that could leave the metadata missing
-                    std::uint32_t seq = static_cast<std::uint32_t>(db->getBigInt("LedgerSeq"));
-                    m_journal.warning << "Recovering ledger " << seq << ", txn " << txn->getID();
-                    Ledger::pointer ledger = getLedgerBySeq(seq);
-                    if (ledger)
-                        ledger->pendSaveValidated(false, false);
-                }
+            unsigned char const* const rawMeta =
+                static_cast <unsigned char const*> (pSt.peekBlob (4));
+            row.rawMeta.assign (rawMeta, rawMeta + pSt.size (4));
+        }
 
-                --numberOfResults;
-                TransactionMetaSet::pointer meta = std::make_shared<TransactionMetaSet> (txn->getID (), txn->getLedger (), rawMeta.getData ());
+        pSt.reset ();
+    }
 
-                ret.push_back (std::pair<Transaction::ref, TransactionMetaSet::ref> (txn, meta));
-            }
+    return true;
+}
+
+std::vector< std::pair<Transaction::pointer, TransactionMetaSet::pointer> >
+NetworkOPsImp::getTxsAccount (const RippleAddress& account, std::int32_t minLedger,
+                              std::int32_t maxLedger, bool forward, Json::Value& token,
+                              int limit, bool bAdmin)
+{
+    std::vector< std::pair<Transaction::pointer, TransactionMetaSet::pointer> > ret;
+
+    std::uint32_t NONBINARY_PAGE_LENGTH = 200;
+
+    std::uint32_t numberOfResults;
+    if (limit <= 0)
+        numberOfResults = NONBINARY_PAGE_LENGTH;
+    else if (!bAdmin && (limit > NONBINARY_PAGE_LENGTH))
+        numberOfResults = NONBINARY_PAGE_LENGTH;
+    else
+        numberOfResults = limit;
+
+    std::vector<AccountTxRow> rows;
+
+    if (!getAccountTxRows (account, minLedger, maxLedger, forward, token,
+            numberOfResults, rows))
+        return ret;
+
+    ret.reserve (rows.size ());
+
+    for (auto const& row : rows)
+    {
+        Transaction::pointer txn = Transaction::transactionFromSQL (
+            row.rawTxn, row.status, row.ledgerSeq, false);
+
+        if (row.rawMeta.empty ())
+        { // Work around a bug that could leave the metadata missing
+            m_journal.warning << "Recovering ledger " << row.ledgerSeq << ", txn " << txn->getID();
+            Ledger::pointer ledger = getLedgerBySeq(row.ledgerSeq);
+            if (ledger)
+                ledger->pendSaveValidated(false, false);
         }
+
+        TransactionMetaSet::pointer meta = std::make_shared<TransactionMetaSet> (txn->getID (), txn->getLedger (), row.rawMeta);
+
+        ret.emplace_back (txn, meta);
     }
 
     return ret;
@@ -2029,101 +2105,26 @@ NetworkOPsImp::getTxsAccountB (const RippleAddress& account, std::int32_t minLed
     std::vector<txnMetaLedgerType> ret;
 
     std::uint32_t BINARY_PAGE_LENGTH = 500;
-    std::uint32_t EXTRA_LENGTH = 20;
-
-    bool foundResume = token.isNull() || !token.isObject();
 
-    std::uint32_t numberOfResults, queryLimit;
+    std::uint32_t numberOfResults;
     if (limit <= 0)
         numberOfResults = BINARY_PAGE_LENGTH;
     else if (!bAdmin && (limit > BINARY_PAGE_LENGTH))
         numberOfResults = BINARY_PAGE_LENGTH;
     else
         numberOfResults = limit;
-    queryLimit = numberOfResults + 1 + (foundResume ? 0 : EXTRA_LENGTH);
 
-    std::uint32_t findLedger = 0, findSeq = 0;
-    if (!foundResume)
-    {
-        try
-        {
-            if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return ret;
-            findLedger = token[jss::ledger].asInt();
-            findSeq = token[jss::seq].asInt();
-        }
-        catch (...)
-        {
-            return ret;
-        }
-    }
+    std::vector<AccountTxRow> rows;
 
-    token = Json::nullValue;
+    if (!getAccountTxRows (account, minLedger, maxLedger, forward, token,
+            numberOfResults, rows))
+        return ret;
 
-    std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
-         "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
-         "WHERE AccountTransactions.Account = '%s' AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
-         "ORDER BY AccountTransactions.LedgerSeq %s, AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
-         "LIMIT %u;")
-             % account.humanAccountID()
-             % ((forward && (findLedger != 0)) ? findLedger : minLedger)
-             % ((!forward && (findLedger != 0)) ? findLedger: maxLedger)
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % (forward ? "ASC" : "DESC")
-             % queryLimit);
-    {
-        Database* db = getApp().getTxnDB ()->getDB ();
-        DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
-
-        SQL_FOREACH (db, sql)
-        {
-            if (!foundResume)
-            {
-                if ((findLedger == db->getInt("LedgerSeq")) && (findSeq == db->getInt("TxnSeq")))
-                    foundResume = true;
-            }
-            else if (numberOfResults == 0)
-            {
-                token = Json::objectValue;
-                token[jss::ledger] = db->getInt("LedgerSeq");
-                token[jss::seq] = db->getInt("TxnSeq");
-                break;
-            }
+    ret.reserve (rows.size ());
 
-            if (foundResume)
-            {
-                int txnSize = 2048;
-                Blob rawTxn (txnSize);
-                txnSize = db->getBinary ("RawTxn", &rawTxn[0], rawTxn.size ());
-
-                if (txnSize > rawTxn.size ())
-                {
-                    rawTxn.resize (txnSize);
-                    db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
-                }
-                else
-                    rawTxn.resize (txnSize);
-
-                int metaSize = 2048;
-                Blob rawMeta (metaSize);
-                metaSize = db->getBinary ("TxnMeta", &rawMeta[0], rawMeta.size ());
-
-                if (metaSize > rawMeta.size ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.size ());
-                }
-                else
-                    rawMeta.resize (metaSize);
-
-                ret.push_back (std::make_tuple (
-                    strHex (rawTxn), strHex (rawMeta), db->getInt ("LedgerSeq")));
-                --numberOfResults;
-            }
-        }
-    }
+    for (auto const& row : rows)
+        ret.push_back (std::make_tuple (
+            strHex (row.rawTxn), strHex (row.rawMeta), row.ledgerSeq));
 
     return ret;
 }
@@ -209,7 +209,7 @@ public:
 
     virtual SHAMapAddNode gotTXData (const std::shared_ptr<Peer>& peer,
         uint256 const& hash, const std::list<SHAMapNode>& nodeIDs,
-        const std::list< Blob >& nodeData) = 0;
+        const std::list<const_byte_view>& nodeData) = 0;
 
     virtual bool recvValidation (SerializedValidation::ref val,
         const std::string& source) = 0;
@@ -35,6 +35,7 @@ const std::shared_ptr<InfoSub>& subscriber, int id, PathRequests& owner,
     , bValid (false)
     , mLastIndex (0)
     , mInProgress (false)
+    , mCanceled (false)
     , iLastLevel (0)
     , bLastSuccess (false)
     , iIdentifier (id)
@@ -121,6 +122,17 @@ void PathRequest::updateComplete ()
     mInProgress = false;
 }
 
+void PathRequest::cancel ()
+{
+    mCanceled = true;
+}
+
+bool PathRequest::isCanceled ()
+{
+    // A request is also abandoned when its subscriber goes away
+    return mCanceled || wpSubscriber.expired ();
+}
+
 bool PathRequest::isValid (RippleLineCache::ref crCache)
 {
     ScopedLockType sl (mLock);
@@ -314,6 +326,7 @@ int PathRequest::parseJson (const Json::Value& jvParams, bool complete)
 Json::Value PathRequest::doClose (const Json::Value&)
 {
     m_journal.debug << iIdentifier << " closed";
+    cancel ();
     ScopedLockType sl (mLock);
     return jvStatus;
 }
@@ -403,6 +416,12 @@ Json::Value PathRequest::doUpdate (RippleLineCache::ref cache, bool fast)
 
     BOOST_FOREACH (const currIssuer_t & currIssuer, sourceCurrencies)
     {
+        if (isCanceled ())
+        {
+            m_journal.debug << iIdentifier << " canceled";
+            break;
+        }
+
         {
             STAmount test (currIssuer.first, currIssuer.second, 1);
             if (m_journal.debug)
@@ -58,6 +58,8 @@ public:
     bool        isNew ();
     bool        needsUpdate (bool newOnly, LedgerIndex index);
     void        updateComplete ();
+    void        cancel ();
+    bool        isCanceled ();
     Json::Value getStatus ();
 
     Json::Value doCreate (const std::shared_ptr<Ledger>&, const RippleLineCache::pointer&,
@@ -98,6 +100,9 @@ private:
     LedgerIndex                     mLastIndex;
     bool                            mInProgress;
 
+    // Set when the client closes or replaces the request
+    std::atomic <bool>              mCanceled;
+
     int                             iLastLevel;
     bool                            bLastSuccess;
 
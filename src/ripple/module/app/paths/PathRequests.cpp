@@ -17,6 +17,10 @@
 */
 //==============================================================================
 
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
 namespace ripple {
 
 /** Get the current RippleLineCache, updating it if necessary.
@@ -35,7 +39,12 @@ RippleLineCache::pointer PathRequests::getLineCache (Ledger::pointer& ledger, bo
          (lgrSeq > (lineSeq + 8)))                         // we jumped way forward for some reason
     {
         ledger = std::make_shared<Ledger>(*ledger, false); // Take a snapshot of the ledger
-        mLineCache = std::make_shared<RippleLineCache> (ledger);
+
+        // Keep the lines of accounts the intervening ledgers did not touch
+        if (mLineCache)
+            mLineCache = std::make_shared<RippleLineCache> (ledger, *mLineCache);
+        else
+            mLineCache = std::make_shared<RippleLineCache> (ledger);
     }
     else
     {
@@ -44,6 +53,52 @@ RippleLineCache::pointer PathRequests::getLineCache (Ledger::pointer& ledger, bo
     return mLineCache;
 }
 
+/** State shared by the threads updating path requests during one pass.
+
+    Requests are handed out in order from a shared index, so older and
+    unserviced requests are started first no matter how many threads help.
+    Helper jobs which start after the pass has finished do nothing.
+*/
+struct PathRequests::UpdatePass
+{
+    UpdatePass (Ledger::ref ledger_, RippleLineCache::ref cache_,
+            std::vector<PathRequest::wptr> const& requests_, bool newRequests_,
+                CancelCallback const& shouldCancel_)
+        : ledger (ledger_)
+        , cache (cache_)
+        , requests (requests_)
+        , newRequests (newRequests_)
+        , shouldCancel (shouldCancel_)
+        , next (0)
+        , stop (false)
+        , mustBreak (false)
+        , processed (0)
+        , removed (0)
+        , threads (0)
+        , done (false)
+    {
+    }
+
+    // Immutable for the duration of the pass
+    Ledger::pointer const ledger;
+    RippleLineCache::pointer const cache;
+    std::vector<PathRequest::wptr> const requests;
+    bool const newRequests;
+    CancelCallback const shouldCancel;
+
+    std::atomic <std::size_t> next;
+    std::atomic <bool> stop;
+    std::atomic <bool> mustBreak;
+    std::atomic <int> processed;
+    std::atomic <int> removed;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    int threads;
+    bool done;
+    std::exception_ptr error;
+};
+
 void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
 {
     std::vector<PathRequest::wptr> requests;
@@ -60,7 +115,6 @@ void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
     }
 
     bool newRequests = getApp().getLedgerMaster().isNewPathRequest();
-    bool mustBreak = false;
 
     mJournal.trace << "updateAll seq=" << ledger->getLedgerSeq() << ", " <<
         requests.size() << " requests";
@@ -68,66 +122,15 @@ void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
 
     do
     {
+        std::shared_ptr <UpdatePass> pass (std::make_shared <UpdatePass> (
+            ledger, cache, requests, newRequests, shouldCancel));
 
-        BOOST_FOREACH (PathRequest::wref wRequest, requests)
-        {
-            if (shouldCancel())
-                break;
+        updatePass (pass);
 
-            bool remove = true;
-            PathRequest::pointer pRequest = wRequest.lock ();
+        processed += pass->processed;
+        removed += pass->removed;
 
-            if (pRequest)
-            {
-                if (!pRequest->needsUpdate (newRequests, ledger->getLedgerSeq ()))
-                    remove = false;
-                else
-                {
-                    InfoSub::pointer ipSub = pRequest->getSubscriber ();
-                    if (ipSub)
-                    {
-                        ipSub->getConsumer ().charge (Resource::feePathFindUpdate);
-                        if (!ipSub->getConsumer ().warn ())
-                        {
-                            Json::Value update = pRequest->doUpdate (cache, false);
-                            pRequest->updateComplete ();
-                            update["type"] = "path_find";
-                            ipSub->send (update, false);
-                            remove = false;
-                            ++processed;
-                        }
-                    }
-                }
-            }
-
-            if (remove)
-            {
-                PathRequest::pointer pRequest = wRequest.lock ();
-
-                ScopedLockType sl (mLock);
-
-                // Remove any dangling weak pointers or weak pointers that refer to this path request.
-                std::vector<PathRequest::wptr>::iterator it = mRequests.begin();
-                while (it != mRequests.end())
-                {
-                    PathRequest::pointer itRequest = it->lock ();
-                    if (!itRequest || (itRequest == pRequest))
-                    {
-                        ++removed;
-                        it = mRequests.erase (it);
-                    }
-                    else
-                        ++it;
-                }
-            }
-
-            mustBreak = !newRequests && getApp().getLedgerMaster().isNewPathRequest();
-            if (mustBreak) // We weren't handling new requests and then there was a new request
-                break;
-
-        }
-
-        if (mustBreak)
+        if (pass->mustBreak)
         { // a new request came in while we were working
             newRequests = true;
         }
@@ -139,7 +142,7 @@ void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
         { // check if there are any new requests, otherwise we are done
             newRequests = getApp().getLedgerMaster().isNewPathRequest();
             if (!newRequests) // We did a full pass and there are no new requests
-                return;
+                break;
         }
 
         {
@@ -160,6 +163,149 @@ void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
         removed << " removed";
 }
 
+/** Update every request in a pass, using helper jobs when worthwhile.
+    The calling thread always works on the pass, so the pass finishes even
+    if no helper job gets to run. Returns once every thread which joined
+    the pass has left it.
+*/
+void PathRequests::updatePass (std::shared_ptr <UpdatePass> const& pass)
+{
+    std::size_t const helpers = std::min <std::size_t> (
+        maxUpdateThreads - 1, pass->requests.size () / 2);
+
+    for (std::size_t i = 0; i < helpers; ++i)
+        getApp().getJobQueue().addJob (jtUPDATE_PF_HELPER, "PathRequests::helpUpdate",
+            std::bind (&PathRequests::helpUpdate, this, pass,
+                       std::placeholders::_1));
+
+    try
+    {
+        updateRequests (*pass);
+    }
+    catch (...)
+    {
+        std::lock_guard <std::mutex> lock (pass->mutex);
+        if (!pass->error)
+            pass->error = std::current_exception ();
+        pass->stop = true;
+    }
+
+    std::unique_lock <std::mutex> lock (pass->mutex);
+    pass->done = true;
+    pass->cond.wait (lock, [&pass] { return pass->threads == 0; });
+
+    if (pass->error)
+        std::rethrow_exception (pass->error);
+}
+
+void PathRequests::helpUpdate (std::shared_ptr <UpdatePass> const& pass, Job&)
+{
+    {
+        std::lock_guard <std::mutex> lock (pass->mutex);
+        if (pass->done)
+            return;
+        ++pass->threads;
+    }
+
+    std::exception_ptr error;
+
+    try
+    {
+        updateRequests (*pass);
+    }
+    catch (...)
+    {
+        error = std::current_exception ();
+    }
+
+    std::lock_guard <std::mutex> lock (pass->mutex);
+    if (error && !pass->error)
+        pass->error = error;
+    if (error)
+        pass->stop = true;
+    if (--pass->threads == 0)
+        pass->cond.notify_all ();
+}
+
+void PathRequests::updateRequests (UpdatePass& pass)
+{
+    while (!pass.stop)
+    {
+        if (pass.shouldCancel ())
+        {
+            pass.stop = true;
+            break;
+        }
+
+        std::size_t const index = pass.next++;
+        if (index >= pass.requests.size ())
+            break;
+
+        updateRequest (pass, pass.requests[index]);
+
+        if (!pass.newRequests && getApp().getLedgerMaster().isNewPathRequest())
+        { // We weren't handling new requests and then there was a new request
+            pass.mustBreak = true;
+            pass.stop = true;
+        }
+    }
+}
+
+void PathRequests::updateRequest (UpdatePass& pass, PathRequest::wref wRequest)
+{
+    bool remove = true;
+    PathRequest::pointer pRequest = wRequest.lock ();
+
+    if (pRequest && !pRequest->isCanceled ())
+    {
+        if (!pRequest->needsUpdate (pass.newRequests, pass.ledger->getLedgerSeq ()))
+            remove = false;
+        else
+        {
+            InfoSub::pointer ipSub = pRequest->getSubscriber ();
+            if (ipSub)
+            {
+                ipSub->getConsumer ().charge (Resource::feePathFindUpdate);
+                if (!ipSub->getConsumer ().warn ())
+                {
+                    Json::Value update = pRequest->doUpdate (pass.cache, false);
+                    pRequest->updateComplete ();
+                    if (!pRequest->isCanceled ())
+                    {
+                        update["type"] = "path_find";
+                        ipSub->send (update, false);
+                    }
+                    remove = false;
+                    ++pass.processed;
+                }
+                else
+                    pRequest->updateComplete ();
+            }
+            else
+                pRequest->updateComplete ();
+        }
+    }
+
+    if (remove)
+    {
+        ScopedLockType sl (mLock);
+
+        // Remove any dangling weak pointers or weak pointers that refer to this path request.
+        std::vector<PathRequest::wptr>::iterator it = mRequests.begin();
+        while (it != mRequests.end())
+        {
+            PathRequest::pointer itRequest = it->lock ();
+            if (!itRequest || (itRequest == pRequest))
+            {
+                ++pass.removed;
+                it = mRequests.erase (it);
+            }
+            else
+                ++it;
+        }
+    }
+}
+
 Json::Value PathRequests::makePathRequest(
     std::shared_ptr <InfoSub> const& subscriber,
     const std::shared_ptr<Ledger>& inLedger,
@@ -53,6 +53,19 @@ public:
     }
 
 private:
+    /** Threads, including the caller of updateAll, that update requests. */
+    enum
+    {
+        maxUpdateThreads = 4
+    };
+
+    struct UpdatePass;
+
+    void updatePass (std::shared_ptr <UpdatePass> const& pass);
+    void updateRequests (UpdatePass& pass);
+    void updateRequest (UpdatePass& pass, PathRequest::wref wRequest);
+    void helpUpdate (std::shared_ptr <UpdatePass> const& pass, Job&);
+
     beast::Journal                   mJournal;
 
     beast::insight::Event            mFast;
@@ -470,46 +470,23 @@ bool Pathfinder::matchesOrigin (const uint160& currency, const uint160& issuer)
 int Pathfinder::getPathsOut (RippleCurrency const& currencyID, const uint160& accountID,
                              bool isDstCurrency, const uint160& dstAccount)
 {
-    // VFALCO TODO Use RippleAsset here
-    std::pair<const uint160&, const uint160&> accountCurrency (currencyID, accountID);
-    // VFALCO TODO Use RippleAsset here
-    ripple::unordered_map<std::pair<uint160, uint160>, int>::iterator it = mPOMap.find (accountCurrency);
+    RippleLineCache::Neighbors const& neighbors (
+        mRLCache->getNeighbors (accountID, currencyID));
 
-    if (it != mPOMap.end ())
-        return it->second;
+    int count = neighbors.pathsOut;
 
-    SLE::pointer sleAccount = mLedger->getSLEi(Ledger::getAccountRootIndex(accountID));
-    if (!sleAccount)
+    if (isDstCurrency)
     {
-        mPOMap[accountCurrency] = 0;
-        return 0;
+        BOOST_FOREACH (RippleLineCache::Neighbor const& neighbor, neighbors.items)
+        {
+            if (neighbor.credit && (neighbor.account == dstAccount))
+            {
+                // count a path to the destination extra
+                count += neighbor.noRipplePeer ? 10000 : 9999;
+            }
+        }
     }
 
-    int aFlags = sleAccount->getFieldU32(sfFlags);
-    bool const bAuthRequired = (aFlags & lsfRequireAuth) != 0;
-
-    int count = 0;
-    AccountItems& rippleLines (mRLCache->getRippleLines (accountID));
-
-    BOOST_FOREACH (AccountItem::ref item, rippleLines.getItems ())
-    {
-        RippleState* rspEntry = (RippleState*) item.get ();
-
-        if (currencyID != rspEntry->getLimit ().getCurrency ())
-            nothing ();
-        else if (rspEntry->getBalance () <= zero &&
-                 (!rspEntry->getLimitPeer ()
-                  || -rspEntry->getBalance () >= rspEntry->getLimitPeer ()
-                  ||  (bAuthRequired && !rspEntry->getAuth ())))
-            nothing ();
-        else if (isDstCurrency && (dstAccount == rspEntry->getAccountIDPeer ()))
-            count += 10000; // count a path to the destination extra
-        else if (rspEntry->getNoRipplePeer ())
-            nothing (); // This probably isn't a useful path out
-        else
-            ++count;
-    }
-    mPOMap[accountCurrency] = count;
     return count;
 }
 
@@ -645,34 +622,27 @@ void Pathfinder::addLink(
         }
         else
         { // search for accounts to add
-            SLE::pointer sleEnd = mLedger->getSLEi(Ledger::getAccountRootIndex(uEndAccount));
-            if (sleEnd)
+            RippleLineCache::Neighbors const& neighbors (
+                mRLCache->getNeighbors (uEndAccount, uEndCurrency));
+            if (neighbors.accountExists)
             {
-                bool const bRequireAuth = is_bit_set(sleEnd->getFieldU32(sfFlags), lsfRequireAuth);
                 bool const bIsEndCurrency = (uEndCurrency == mDstAmount.getCurrency());
                 bool const bIsNoRippleOut = isNoRippleOut (currentPath);
 
-                AccountItems& rippleLines (mRLCache->getRippleLines(uEndAccount));
-
                 std::vector< std::pair<int, uint160> > candidates;
-                candidates.reserve(rippleLines.getItems().size());
+                candidates.reserve(neighbors.items.size());
 
-                BOOST_FOREACH(AccountItem::ref item, rippleLines.getItems())
+                BOOST_FOREACH(RippleLineCache::Neighbor const& neighbor, neighbors.items)
                 {
-                    RippleState const& rspEntry = * reinterpret_cast<RippleState const *>(item.get());
-                    uint160 const& acctID = rspEntry.getAccountIDPeer();
+                    uint160 const& acctID = neighbor.account;
 
-                    if ((uEndCurrency == rspEntry.getLimit().getCurrency()) &&
-                        !currentPath.hasSeen(acctID, uEndCurrency, acctID))
+                    if (!currentPath.hasSeen(acctID, uEndCurrency, acctID))
                     { // path is for correct currency and has not been seen
-                        if (rspEntry.getBalance() <= zero
-                            && (!rspEntry.getLimitPeer()
-                                || -rspEntry.getBalance() >= rspEntry.getLimitPeer()
-                                || (bRequireAuth && !rspEntry.getAuth())))
+                        if (!neighbor.credit)
                         {
                             // path has no credit
                         }
-                        else if (bIsNoRippleOut && rspEntry.getNoRipple())
+                        else if (bIsNoRippleOut && neighbor.noRipple)
                         {
                             // Can't leave on this path
                         }
@@ -736,7 +706,7 @@ void Pathfinder::addLink(
     { // add order books
         if (addFlags & afOB_XRP)
         { // to XRP only
-            if (!bOnXRP && getApp().getOrderBookDB().isBookToXRP(uEndIssuer, uEndCurrency))
+            if (!bOnXRP && mRLCache->getBooksByTakerPays(uEndIssuer, uEndCurrency).toXRP)
             {
                 incompletePaths.assembleAdd(currentPath, STPathElement(STPathElement::typeCurrency, ACCOUNT_XRP, CURRENCY_XRP, ACCOUNT_XRP));
             }
@@ -744,8 +714,8 @@ void Pathfinder::addLink(
         else
         {
             bool bDestOnly = (addFlags & afOB_LAST) != 0;
-            std::vector<OrderBook::pointer> books;
-            getApp().getOrderBookDB().getBooksByTakerPays(uEndIssuer, uEndCurrency, books);
+            std::vector<OrderBook::pointer> const& books (
+                mRLCache->getBooksByTakerPays(uEndIssuer, uEndCurrency).books);
             WriteLog (lsTRACE, Pathfinder) << books.size() << " books found from this currency/issuer";
             BOOST_FOREACH(OrderBook::ref book, books)
             {
@@ -19,16 +19,124 @@
 
 namespace ripple {
 
+SETUP_LOG (RippleLineCache)
+
 RippleLineCache::RippleLineCache (Ledger::ref l)
     : mLedger (l)
 {
 }
 
+RippleLineCache::RippleLineCache (Ledger::ref l, RippleLineCache& previous)
+    : mLedger (l)
+    , mCarried (carryForward (l, previous))
+{
+}
+
+RippleLineCache::Carried RippleLineCache::carryForward (
+    Ledger::ref l, RippleLineCache& previous)
+{
+    Carried carried;
+    ripple::unordered_set <uint160> touched;
+
+    if (!getTouchedAccounts (l, previous.mLedger, touched))
+        return carried;
+
+    // Only entries used on the previous ledger are kept. Otherwise every
+    // account ever looked up would stay in the cache.
+    for (auto const& it : previous.mCarried.lines)
+    {
+        if (it.second.used && (touched.count (it.first) == 0))
+            carry (carried.lines, it.first, it.second.value);
+    }
+
+    for (auto const& it : previous.mCarried.neighbors)
+    {
+        if (it.second.used && (touched.count (it.first.first) == 0))
+            carry (carried.neighbors, it.first, it.second.value);
+    }
+
+    {
+        // Entries built for the previous ledger were used by definition
+        ScopedLockType sl (previous.mLock);
+
+        for (auto const& it : previous.mRLMap)
+        {
+            if (touched.count (it.first) == 0)
+                carry (carried.lines, it.first, it.second);
+        }
+
+        for (auto const& it : previous.mNeighbors)
+        {
+            if (touched.count (it.first.first) == 0)
+                carry (carried.neighbors, it.first, it.second);
+        }
+    }
+
+    WriteLog (lsDEBUG, RippleLineCache) << "Carried " << carried.lines.size () <<
+        " accounts to ledger " << l->getLedgerSeq () << ", " <<
+        touched.size () << " touched";
+
+    return carried;
+}
+
+/** Collect the accounts touched by the transactions after a base ledger.
+    @return `false` if the base ledger is not a recent ancestor of the
+            ledger, or the metadata needed is not available.
+*/
+bool RippleLineCache::getTouchedAccounts (Ledger::ref l, Ledger::ref base,
+    ripple::unordered_set <uint160>& accounts)
+{
+    // Open ledgers have no metadata to tell us what changed
+    if (!l->isClosed () || !base->isClosed ())
+        return false;
+
+    uint256 const baseHash = base->getHash ();
+
+    if (l->getHash () == baseHash)
+        return true;
+
+    Ledger::pointer ledger = l;
+
+    for (int i = 0; i < maxCarryLedgers; ++i)
+    {
+        AcceptedLedger::pointer accepted (
+            AcceptedLedger::makeAcceptedLedger (ledger));
+
+        BOOST_FOREACH (AcceptedLedger::value_type const& item, accepted->getMap ())
+        {
+            BOOST_FOREACH (RippleAddress const& account, item.second->getAffected ())
+                accounts.insert (account.getAccountID ());
+        }
+
+        if (ledger->getParentHash () == baseHash)
+            return true;
+
+        if (ledger->getLedgerSeq () <= base->getLedgerSeq ())
+            return false;
+
+        ledger = getApp().getLedgerMaster ().getLedgerByHash (
+            ledger->getParentHash ());
+
+        if (!ledger || !ledger->isClosed ())
+            return false;
+    }
+
+    return false;
+}
+
 AccountItems& RippleLineCache::getRippleLines (const uint160& accountID)
 {
+    auto const carried = mCarried.lines.find (accountID);
+
+    if (carried != mCarried.lines.end ())
+    {
+        markUsed (carried->second);
+        return *carried->second.value;
+    }
+
     ScopedLockType sl (mLock);
 
-    ripple::unordered_map <uint160, AccountItems::pointer>::iterator it = mRLMap.find (accountID);
+    LineMap::iterator it = mRLMap.find (accountID);
 
     if (it == mRLMap.end ())
         it = mRLMap.insert (std::make_pair (accountID, std::make_shared<AccountItems>
@@ -37,4 +145,93 @@ AccountItems& RippleLineCache::getRippleLines (const uint160& accountID)
     return *it->second;
 }
 
+RippleLineCache::Neighbors const& RippleLineCache::getNeighbors (
+    uint160 const& accountID, uint160 const& currencyID)
+{
+    std::pair <uint160, uint160> const key (accountID, currencyID);
+
+    auto const carried = mCarried.neighbors.find (key);
+
+    if (carried != mCarried.neighbors.end ())
+    {
+        markUsed (carried->second);
+        return *carried->second.value;
+    }
+
+    {
+        ScopedLockType sl (mLock);
+        NeighborMap::const_iterator const it = mNeighbors.find (key);
+        if (it != mNeighbors.end ())
+            return *it->second;
+    }
+
+    // Built without the lock since it loads the account's lines. If another
+    // thread got there first, its entry is kept.
+    std::shared_ptr <Neighbors const> neighbors (
+        makeNeighbors (accountID, currencyID));
+
+    ScopedLockType sl (mLock);
+    return *mNeighbors.insert (std::make_pair (key, neighbors)).first->second;
+}
+
+std::shared_ptr <RippleLineCache::Neighbors const> RippleLineCache::makeNeighbors (
+    uint160 const& accountID, uint160 const& currencyID)
+{
+    std::shared_ptr <Neighbors> neighbors (std::make_shared <Neighbors> ());
+    neighbors->pathsOut = 0;
+
+    SLE::pointer sleAccount = mLedger->getSLEi (Ledger::getAccountRootIndex (accountID));
+    neighbors->accountExists = !!sleAccount;
+
+    if (!sleAccount)
+        return neighbors;
+
+    bool const bRequireAuth = is_bit_set (sleAccount->getFieldU32 (sfFlags), lsfRequireAuth);
+
+    BOOST_FOREACH (AccountItem::ref item, getRippleLines (accountID).getItems ())
+    {
+        RippleState const& rspEntry = * reinterpret_cast<RippleState const *>(item.get());
+
+        if (currencyID != rspEntry.getLimit ().getCurrency ())
+            continue;
+
+        Neighbor neighbor;
+        neighbor.account = rspEntry.getAccountIDPeer ();
+        neighbor.credit = rspEntry.getBalance () > zero ||
+            (rspEntry.getLimitPeer ()
+             && -rspEntry.getBalance () < rspEntry.getLimitPeer ()
+             && (!bRequireAuth || rspEntry.getAuth ()));
+        neighbor.noRipple = rspEntry.getNoRipple ();
+        neighbor.noRipplePeer = rspEntry.getNoRipplePeer ();
+
+        if (neighbor.credit && !neighbor.noRipplePeer)
+            ++neighbors->pathsOut;
+
+        neighbors->items.push_back (neighbor);
+    }
+
+    return neighbors;
+}
+
+RippleLineCache::Books const& RippleLineCache::getBooksByTakerPays (
+    uint160 const& issuerID, uint160 const& currencyID)
+{
+    RippleAsset const asset (currencyID, issuerID);
+
+    {
+        ScopedLockType sl (mLock);
+        BookMap::const_iterator const it = mBooks.find (asset);
+        if (it != mBooks.end ())
+            return *it->second;
+    }
+
+    std::shared_ptr <Books> books (std::make_shared <Books> ());
+    OrderBookDB& orderBookDB (getApp().getOrderBookDB ());
+    orderBookDB.getBooksByTakerPays (issuerID, currencyID, books->books);
+    books->toXRP = orderBookDB.isBookToXRP (issuerID, currencyID);
+
+    ScopedLockType sl (mLock);
+    return *mBooks.insert (std::make_pair (asset, books)).first->second;
+}
+
 } // ripple
@@ -22,15 +22,56 @@
 
 namespace ripple {
 
-// Used by Pathfinder
+/** The trust lines and order books of one ledger, shared by Pathfinders.
+
+    Besides the raw trust lines of each account, the cache keeps a compact
+    index of the liquidity graph: for an account and currency, the peers
+    reachable over a trust line, and for an asset, the order books which
+    take it. Entries are built once per ledger on first use and never
+    change afterwards, so every path request on the ledger shares them.
+*/
 class RippleLineCache
 {
 public:
     typedef std::shared_ptr <RippleLineCache> pointer;
     typedef pointer const& ref;
 
+    /** A trust line out of an account, reduced to what path finding needs. */
+    struct Neighbor
+    {
+        uint160 account;        // The peer on the other side of the line
+        bool credit;            // The account can send to the peer
+        bool noRipple;          // The account set no ripple on the line
+        bool noRipplePeer;      // The peer set no ripple on the line
+    };
+
+    /** The neighbors of an account in one currency. */
+    struct Neighbors
+    {
+        bool accountExists;
+        int pathsOut;           // Neighbors with credit which allow rippling
+        std::vector <Neighbor> items;
+    };
+
+    /** The order books which take an asset. */
+    struct Books
+    {
+        bool toXRP;
+        std::vector <OrderBook::pointer> books;
+    };
+
     explicit RippleLineCache (Ledger::ref l);
 
+    /** Create a cache for a ledger which follows an earlier cache's ledger.
+        Entries which the earlier cache used are carried forward, unless a
+        transaction between the two ledgers touched their account. Entries
+        nobody used on the earlier ledger are dropped, so the cache holds
+        what path finding currently needs. If the ledgers are not closed, or
+        the new ledger does not descend from the old one within a few
+        ledgers, the new cache starts out empty.
+    */
+    RippleLineCache (Ledger::ref l, RippleLineCache& previous);
+
     Ledger::ref getLedger () // VFALCO TODO const?
     {
         return mLedger;
@@ -38,14 +79,89 @@ public:
 
     AccountItems& getRippleLines (const uint160& accountID);
 
+    Neighbors const& getNeighbors (uint160 const& accountID,
+        uint160 const& currencyID);
+
+    Books const& getBooksByTakerPays (uint160 const& issuerID,
+        uint160 const& currencyID);
+
 private:
+    typedef ripple::unordered_map <uint160, AccountItems::pointer> LineMap;
+
+    typedef ripple::unordered_map <std::pair <uint160, uint160>,
+        std::shared_ptr <Neighbors const>> NeighborMap;
+
+    typedef ripple::unordered_map <RippleAsset,
+        std::shared_ptr <Books const>> BookMap;
+
+    // An entry carried forward from an earlier ledger, and whether it has
+    // been used on this one
+    template <class Value>
+    struct CarriedEntry
+    {
+        explicit CarriedEntry (Value const& value_)
+            : value (value_)
+            , used (false)
+        {
+        }
+
+        Value const value;
+        mutable std::atomic <bool> used;
+    };
+
+    // Entries carried forward from an earlier ledger
+    struct Carried
+    {
+        ripple::unordered_map <uint160,
+            CarriedEntry <AccountItems::pointer>> lines;
+
+        ripple::unordered_map <std::pair <uint160, uint160>,
+            CarriedEntry <std::shared_ptr <Neighbors const>>> neighbors;
+    };
+
+    // Ledgers to walk back looking for the previous cache's ledger
+    enum
+    {
+        maxCarryLedgers = 8
+    };
+
+    static Carried carryForward (Ledger::ref l, RippleLineCache& previous);
+
+    template <class Map, class Key, class Value>
+    static void carry (Map& map, Key const& key, Value const& value)
+    {
+        map.emplace (std::piecewise_construct,
+            std::forward_as_tuple (key), std::forward_as_tuple (value));
+    }
+
+    template <class Entry>
+    static void markUsed (Entry const& entry)
+    {
+        // Checked first so that busy entries are not written by every lookup
+        if (!entry.used.load (std::memory_order_relaxed))
+            entry.used.store (true, std::memory_order_relaxed);
+    }
+
+    static bool getTouchedAccounts (Ledger::ref l, Ledger::ref base,
+        ripple::unordered_set <uint160>& accounts);
+
+    std::shared_ptr <Neighbors const> makeNeighbors (
+        uint160 const& accountID, uint160 const& currencyID);
+
     typedef RippleMutex LockType;
     typedef std::lock_guard <LockType> ScopedLockType;
     LockType mLock;
    
     Ledger::pointer mLedger;
-    
-    ripple::unordered_map <uint160, AccountItems::pointer> mRLMap;
+
+    // Entries carried forward from an earlier ledger. Only their used flags
+    // change after construction, so lookups in them do not take the lock.
+    Carried const mCarried;
+
+    // Entries built for this ledger
+    LineMap mRLMap;
+    NeighborMap mNeighbors;
+    BookMap mBooks;
 };
 
 } // ripple
@@ -19,6 +19,8 @@
 
 #include <beast/unit_test/suite.h>
 
+#include <condition_variable>
+
 namespace ripple {
 
 SETUP_LOG (SHAMap)
@@ -44,7 +46,7 @@ SHAMap::SHAMap (SHAMapType t, FullBelowCache& fullBelowCache, std::uint32_t seq,
     if (t == smtSTATE)
         mTNByID.rehash (STATE_MAP_BUCKETS);
 
-    root = std::make_shared<SHAMapTreeNode> (mSeq, SHAMapNode (0, uint256 ()));
+    root = SHAMapTreeNode::create (mSeq, SHAMapNode (0, uint256 ()));
     root->makeInner ();
     mTNByID.replace(*root, root);
 }
@@ -62,12 +64,12 @@ SHAMap::SHAMap (SHAMapType t, uint256 const& hash, FullBelowCache& fullBelowCach
     if (t == smtSTATE)
         mTNByID.rehash (STATE_MAP_BUCKETS);
 
-    root = std::make_shared<SHAMapTreeNode> (mSeq, SHAMapNode (0, uint256 ()));
+    root = SHAMapTreeNode::create (mSeq, SHAMapNode (0, uint256 ()));
     root->makeInner ();
     mTNByID.replace(*root, root);
 }
 
-TaggedCache <uint256, SHAMapTreeNode>
+ShardedTaggedCache <uint256, SHAMapTreeNode>
     SHAMap::treeNodeCache ("TreeNodeCache", 65536, 60,
         get_seconds_clock (),
             LogPartition::getJournal <TaggedCacheLog> ());
@@ -123,10 +125,10 @@ SHAMap::pointer SHAMap::snapShot (bool isMutable)
     // Return a new SHAMap that is a snapshot of this one
     // Initially most nodes are shared and CoW is forced where needed
     {
-        ScopedReadLockType sl (mLock);
+        ScopedReadLockType sl (lockForRead ());
         newMap.mSeq = mSeq;
         newMap.mTNByID = mTNByID;
-        newMap.root = root;
+        newMap.root = getRoot ();
 
         if (!isMutable)
             newMap.mState = smsImmutable;
@@ -138,7 +140,7 @@ SHAMap::pointer SHAMap::snapShot (bool isMutable)
             {
                 if (nodeIt.second->getSeq() == mSeq)
                 { // We might modify this node, so duplicate it in the snapShot
-                    SHAMapTreeNode::pointer newNode = std::make_shared<SHAMapTreeNode> (*nodeIt.second, mSeq);
+                    SHAMapTreeNode::pointer newNode = SHAMapTreeNode::create (*nodeIt.second, mSeq);
                     newMap.mTNByID.replace (*newNode, newNode);
                     if (newNode->isRoot ())
                         newMap.root = newNode;
@@ -157,7 +159,7 @@ std::stack<SHAMapTreeNode::pointer> SHAMap::getStack (uint256 const& id, bool in
     // Walk the tree as far as possible to the specified identifier
     // produce a stack of nodes along the way, with the terminal node at the top
     std::stack<SHAMapTreeNode::pointer> stack;
-    SHAMapTreeNode::pointer node = root;
+    SHAMapTreeNode::pointer node = getRoot ();
 
     while (!node->isLeaf ())
     {
@@ -231,7 +233,7 @@ SHAMapTreeNode::pointer SHAMap::walkTo (uint256 const& id, bool modify)
 {
     // walk down to the terminal node for this ID
 
-    SHAMapTreeNode::pointer inNode = root;
+    SHAMapTreeNode::pointer inNode = getRoot ();
 
     while (!inNode->isLeaf ())
     {
@@ -260,22 +262,47 @@ SHAMapTreeNode::pointer SHAMap::walkTo (uint256 const& id, bool modify)
     return inNode;
 }
 
-SHAMapTreeNode* SHAMap::walkToPointer (uint256 const& id)
+SHAMapTreeNode::pointer SHAMap::walkToLeaf (uint256 const& id)
 {
-    SHAMapTreeNode* inNode = root.get ();
+    SHAMapTreeNode::pointer inNode = getRoot ();
 
     while (!inNode->isLeaf ())
     {
         int branch = inNode->selectBranch (id);
 
         if (inNode->isEmptyBranch (branch))
-            return nullptr;
+            return SHAMapTreeNode::pointer ();
 
-        inNode = getNodePointer (inNode->getChildNodeID (branch), inNode->getChildHash (branch));
-        assert (inNode);
+        inNode = descend (inNode.get (), branch);
     }
 
-    return (inNode->getTag () == id) ? inNode : nullptr;
+    if (inNode->getTag () != id)
+        return SHAMapTreeNode::pointer ();
+
+    return inNode;
+}
+
+/** Get a child of an inner node, for reading
+
+    Immutable children are remembered by their parent, so walks which
+    have been down a branch before can follow it again without going
+    through mTNByID. The returned node must not be modified.
+*/
+SHAMapTreeNode::pointer SHAMap::descend (SHAMapTreeNode* parent, int branch)
+{
+    SHAMapTreeNode::pointer child = parent->getChild (branch);
+
+    if (!child)
+    {
+        child = getNode (parent->getChildNodeID (branch),
+            parent->getChildHash (branch), false);
+
+        // Mutable nodes belong to one map and must be found through it
+        if (child->getSeq () == 0)
+            parent->setChild (branch, child);
+    }
+
+    return child;
 }
 
 SHAMapTreeNode::pointer SHAMap::getNode (const SHAMapNode& id, uint256 const& hash, bool modify)
@@ -343,8 +370,8 @@ SHAMapTreeNode* SHAMap::getNodePointerNT (const SHAMapNode& id, uint256 const& h
 
         if (filter->haveNode (id, hash, nodeData))
         {
-            SHAMapTreeNode::pointer node = std::make_shared<SHAMapTreeNode> (
-                    boost::cref (id), boost::cref (nodeData), 0, snfPREFIX, boost::cref (hash), true);
+            SHAMapTreeNode::pointer node = SHAMapTreeNode::create (
+                    boost::cref (id), nodeData, 0, snfPREFIX, boost::cref (hash), true);
             canonicalize (hash, node);
 
             // Canonicalize the node with mTNByID to make sure all threads gets the same node
@@ -372,13 +399,13 @@ void SHAMap::returnNode (SHAMapTreeNode::pointer& node, bool modify)
         assert (node->getSeq () < mSeq);
         assert (mState != smsImmutable);
 
-        node = std::make_shared<SHAMapTreeNode> (*node, mSeq); // here's to the new node, same as the old node
+        node = SHAMapTreeNode::create (*node, mSeq); // here's to the new node, same as the old node
         assert (node->isValid ());
 
         mTNByID.replace (*node, node);
 
         if (node->isRoot ())
-            root = node;
+            setRoot (node);
 
         if (mDirtyNodes)
             mDirtyNodes->insert (*node);
@@ -392,7 +419,7 @@ void SHAMap::trackNewNode (SHAMapTreeNode::pointer& node)
         mDirtyNodes->insert (*node);
 }
 
-SHAMapTreeNode* SHAMap::firstBelow (SHAMapTreeNode* node)
+SHAMapTreeNode::pointer SHAMap::firstBelow (SHAMapTreeNode::pointer node)
 {
     // Return the first item below this node
     do
@@ -406,18 +433,18 @@ SHAMapTreeNode* SHAMap::firstBelow (SHAMapTreeNode* node)
         for (int i = 0; i < 16; ++i)
             if (!node->isEmptyBranch (i))
             {
-                node = getNodePointer (node->getChildNodeID (i), node->getChildHash (i));
+                node = descend (node.get (), i);
                 foundNode = true;
                 break;
             }
 
         if (!foundNode)
-            return nullptr;
+            return SHAMapTreeNode::pointer ();
     }
     while (true);
 }
 
-SHAMapTreeNode* SHAMap::lastBelow (SHAMapTreeNode* node)
+SHAMapTreeNode::pointer SHAMap::lastBelow (SHAMapTreeNode::pointer node)
 {
     do
     {
@@ -427,26 +454,26 @@ SHAMapTreeNode* SHAMap::lastBelow (SHAMapTreeNode* node)
 
         bool foundNode = false;
 
-        for (int i = 15; i >= 0; ++i)
+        for (int i = 15; i >= 0; --i)
             if (!node->isEmptyBranch (i))
             {
-                node = getNodePointer (node->getChildNodeID (i), node->getChildHash (i));
+                node = descend (node.get (), i);
                 foundNode = true;
                 break;
             }
 
         if (!foundNode)
-            return nullptr;
+            return SHAMapTreeNode::pointer ();
     }
     while (true);
 }
 
-SHAMapItem::pointer SHAMap::onlyBelow (SHAMapTreeNode* node)
+SHAMapItem::pointer SHAMap::onlyBelow (SHAMapTreeNode::pointer node)
 {
     // If there is only one item below this node, return it
     while (!node->isLeaf ())
     {
-        SHAMapTreeNode* nextNode = nullptr;
+        SHAMapTreeNode::pointer nextNode;
 
         for (int i = 0; i < 16; ++i)
             if (!node->isEmptyBranch (i))
@@ -454,7 +481,7 @@ SHAMapItem::pointer SHAMap::onlyBelow (SHAMapTreeNode* node)
                 if (nextNode)
                     return SHAMapItem::pointer (); // two leaves below
 
-                nextNode = getNodePointer (node->getChildNodeID (i), node->getChildHash (i));
+                nextNode = descend (node.get (), i);
             }
 
         if (!nextNode)
@@ -509,9 +536,9 @@ static const SHAMapItem::pointer no_item;
 
 SHAMapItem::pointer SHAMap::peekFirstItem ()
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    SHAMapTreeNode* node = firstBelow (root.get ());
+    SHAMapTreeNode::pointer node = firstBelow (getRoot ());
 
     if (!node)
         return no_item;
@@ -521,9 +548,9 @@ SHAMapItem::pointer SHAMap::peekFirstItem ()
 
 SHAMapItem::pointer SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type)
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    SHAMapTreeNode* node = firstBelow (root.get ());
+    SHAMapTreeNode::pointer node = firstBelow (getRoot ());
 
     if (!node)
         return no_item;
@@ -534,9 +561,9 @@ SHAMapItem::pointer SHAMap::peekFirstItem (SHAMapTreeNode::TNType& type)
 
 SHAMapItem::pointer SHAMap::peekLastItem ()
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    SHAMapTreeNode* node = lastBelow (root.get ());
+    SHAMapTreeNode::pointer node = lastBelow (getRoot ());
 
     if (!node)
         return no_item;
@@ -554,7 +581,7 @@ SHAMapItem::pointer SHAMap::peekNextItem (uint256 const& id)
 SHAMapItem::pointer SHAMap::peekNextItem (uint256 const& id, SHAMapTreeNode::TNType& type)
 {
     // Get a pointer to the next item in the tree after a given item - item need not be in tree
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
     std::stack<SHAMapTreeNode::pointer> stack = getStack (id, true);
 
@@ -575,9 +602,7 @@ SHAMapItem::pointer SHAMap::peekNextItem (uint256 const& id, SHAMapTreeNode::TNT
             for (int i = node->selectBranch (id) + 1; i < 16; ++i)
                 if (!node->isEmptyBranch (i))
                 {
-                    SHAMapTreeNode* firstNode = getNodePointer (node->getChildNodeID (i), node->getChildHash (i));
-                    assert (firstNode);
-                    firstNode = firstBelow (firstNode);
+                    SHAMapTreeNode::pointer firstNode = firstBelow (descend (node.get (), i));
 
                     if (!firstNode || firstNode->isInner ())
                         throw (std::runtime_error ("missing/corrupt node"));
@@ -594,7 +619,7 @@ SHAMapItem::pointer SHAMap::peekNextItem (uint256 const& id, SHAMapTreeNode::TNT
 // Get a pointer to the previous item in the tree after a given item - item need not be in tree
 SHAMapItem::pointer SHAMap::peekPrevItem (uint256 const& id)
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
     std::stack<SHAMapTreeNode::pointer> stack = getStack (id, true);
 
@@ -614,8 +639,7 @@ SHAMapItem::pointer SHAMap::peekPrevItem (uint256 const& id)
             {
                 if (!node->isEmptyBranch (i))
                 {
-                    node = getNode (node->getChildNodeID (i), node->getChildHash (i), false);
-                    SHAMapTreeNode* item = firstBelow (node.get ());
+                    SHAMapTreeNode::pointer item = firstBelow (descend (node.get (), i));
 
                     if (!item)
                         throw (std::runtime_error ("missing node"));
@@ -632,9 +656,9 @@ SHAMapItem::pointer SHAMap::peekPrevItem (uint256 const& id)
 
 SHAMapItem::pointer SHAMap::peekItem (uint256 const& id)
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapTreeNode::pointer leaf = walkToLeaf (id);
 
     if (!leaf)
         return no_item;
@@ -644,9 +668,9 @@ SHAMapItem::pointer SHAMap::peekItem (uint256 const& id)
 
 SHAMapItem::pointer SHAMap::peekItem (uint256 const& id, SHAMapTreeNode::TNType& type)
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapTreeNode::pointer leaf = walkToLeaf (id);
 
     if (!leaf)
         return no_item;
@@ -657,9 +681,9 @@ SHAMapItem::pointer SHAMap::peekItem (uint256 const& id, SHAMapTreeNode::TNType&
 
 SHAMapItem::pointer SHAMap::peekItem (uint256 const& id, uint256& hash)
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapTreeNode::pointer leaf = walkToLeaf (id);
 
     if (!leaf)
         return no_item;
@@ -672,9 +696,9 @@ SHAMapItem::pointer SHAMap::peekItem (uint256 const& id, uint256& hash)
 bool SHAMap::hasItem (uint256 const& id)
 {
     // does the tree have an item with this ID
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    SHAMapTreeNode* leaf = walkToPointer (id);
+    SHAMapTreeNode::pointer leaf = walkToLeaf (id);
     return (leaf != nullptr);
 }
 
@@ -731,7 +755,7 @@ bool SHAMap::delItem (uint256 const& id)
             else if (bc == 1)
             {
                 // pull up on the thread
-                SHAMapItem::pointer item = onlyBelow (node.get ());
+                SHAMapItem::pointer item = onlyBelow (node);
 
                 if (item)
                 {
@@ -785,7 +809,7 @@ bool SHAMap::addGiveItem (SHAMapItem::ref item, bool isTransaction, bool hasMeta
         int branch = node->selectBranch (tag);
         assert (node->isEmptyBranch (branch));
         SHAMapTreeNode::pointer newNode =
-            std::make_shared<SHAMapTreeNode> (node->getChildNodeID (branch), item, type, mSeq);
+            SHAMapTreeNode::create (node->getChildNodeID (branch), item, type, mSeq);
 
         if (!mTNByID.peekMap().emplace (SHAMapNode (*newNode), newNode).second)
         {
@@ -813,7 +837,7 @@ bool SHAMap::addGiveItem (SHAMapItem::ref item, bool isTransaction, bool hasMeta
         {
             // we need a new inner node, since both go on same branch at this level
             SHAMapTreeNode::pointer newNode =
-                std::make_shared<SHAMapTreeNode> (mSeq, node->getChildNodeID (b1));
+                SHAMapTreeNode::create (mSeq, node->getChildNodeID (b1));
             newNode->makeInner ();
 
             if (!mTNByID.peekMap().emplace (SHAMapNode (*newNode), newNode).second)
@@ -827,7 +851,7 @@ bool SHAMap::addGiveItem (SHAMapItem::ref item, bool isTransaction, bool hasMeta
         // we can add the two leaf nodes here
         assert (node->isInner ());
         SHAMapTreeNode::pointer newNode =
-            std::make_shared<SHAMapTreeNode> (node->getChildNodeID (b1), item, type, mSeq);
+            SHAMapTreeNode::create (node->getChildNodeID (b1), item, type, mSeq);
         assert (newNode->isValid () && newNode->isLeaf ());
 
         if (!mTNByID.peekMap().emplace (SHAMapNode (*newNode), newNode).second)
@@ -836,7 +860,7 @@ bool SHAMap::addGiveItem (SHAMapItem::ref item, bool isTransaction, bool hasMeta
         node->setChildHash (b1, newNode->getNodeHash ()); // OPTIMIZEME hash op not needed
         trackNewNode (newNode);
 
-        newNode = std::make_shared<SHAMapTreeNode> (node->getChildNodeID (b2), otherItem, type, mSeq);
+        newNode = SHAMapTreeNode::create (node->getChildNodeID (b2), otherItem, type, mSeq);
         assert (newNode->isValid () && newNode->isLeaf ());
 
         if (!mTNByID.peekMap().emplace (SHAMapNode (*newNode), newNode).second)
@@ -931,8 +955,8 @@ SHAMapTreeNode* SHAMap::getNodeAsync (
             Blob nodeData;
             if (filter->haveNode (id, hash, nodeData))
             {
-                ptr = std::make_shared <SHAMapTreeNode> (
-                    boost::cref (id), boost::cref (nodeData), 0, snfPREFIX, boost::cref (hash), true);
+                ptr = SHAMapTreeNode::create (
+                    boost::cref (id), nodeData, 0, snfPREFIX, boost::cref (hash), true);
                 filter->gotNode (true, id, hash, nodeData, ptr->getType ());
             }
         }
@@ -957,7 +981,7 @@ SHAMapTreeNode* SHAMap::getNodeAsync (
             if (!obj)
                 return nullptr;
 
-            ptr = std::make_shared <SHAMapTreeNode> (id, obj->getData(), 0, snfPREFIX, hash, true);
+            ptr = SHAMapTreeNode::create (id, obj->getData(), 0, snfPREFIX, hash, true);
             if (id != *ptr)
             {
                 assert (false);
@@ -973,7 +997,7 @@ SHAMapTreeNode* SHAMap::getNodeAsync (
     {
         // It is legal to replace the root
         mTNByID.replace (id, ptr);
-        root = ptr;
+        setRoot (ptr);
     }
     else
         mTNByID.canonicalize (id, &ptr);
@@ -1019,7 +1043,7 @@ SHAMapTreeNode::pointer SHAMap::fetchNodeExternalNT (const SHAMapNode& id, uint2
         {
             // We make this node immutable (seq == 0) so that it can be shared
             // CoW is needed if it is modified
-            ret = std::make_shared<SHAMapTreeNode> (id, obj->getData (), 0, snfPREFIX, hash, true);
+            ret = SHAMapTreeNode::create (id, obj->getData (), 0, snfPREFIX, hash, true);
 
             if (id != *ret)
             {
@@ -1048,7 +1072,7 @@ SHAMapTreeNode::pointer SHAMap::fetchNodeExternalNT (const SHAMapNode& id, uint2
     if (id.isRoot ()) // it is legal to replace an existing root
     {
         mTNByID.replace(id, ret);
-        root = ret;
+        setRoot (ret);
     }
     else // Make sure other threads get pointers to the same underlying object
        mTNByID.canonicalize (id, &ret);
@@ -1057,7 +1081,7 @@ SHAMapTreeNode::pointer SHAMap::fetchNodeExternalNT (const SHAMapNode& id, uint2
 
 bool SHAMap::fetchRoot (uint256 const& hash, SHAMapSyncFilter* filter)
 {
-    if (hash == root->getNodeHash ())
+    if (hash == getRoot ()->getNodeHash ())
         return true;
 
     if (ShouldLog (lsTRACE, SHAMap))
@@ -1072,24 +1096,22 @@ bool SHAMap::fetchRoot (uint256 const& hash, SHAMapSyncFilter* filter)
 
     SHAMapTreeNode::pointer newRoot = fetchNodeExternalNT(SHAMapNode(), hash);
     
-    if (newRoot)
-    {
-        root = newRoot;
-    }
-    else
+    if (!newRoot)
     {
         Blob nodeData;
 
         if (!filter || !filter->haveNode (SHAMapNode (), hash, nodeData))
             return false;
 
-        root = std::make_shared<SHAMapTreeNode> (SHAMapNode (), nodeData,
+        newRoot = SHAMapTreeNode::create (SHAMapNode (), nodeData,
                 mSeq - 1, snfPREFIX, hash, true);
-        mTNByID.replace(*root, root);
-        filter->gotNode (true, SHAMapNode (), hash, nodeData, root->getType ());
+        mTNByID.replace(*newRoot, newRoot);
+        filter->gotNode (true, SHAMapNode (), hash, nodeData, newRoot->getType ());
     }
 
-    assert (root->getNodeHash () == hash);
+    setRoot (newRoot);
+
+    assert (newRoot->getNodeHash () == hash);
     return true;
 }
 
@@ -1100,55 +1122,179 @@ int SHAMap::armDirty ()
     return ++mSeq;
 }
 
-/** Write all modified nodes to the node store */
+/** Nodes taken from the dirty set in one call to flushDirty.
+
+    The nodes are grouped by the branch of the root they sit under, and
+    the groups are handed out from a shared index to the calling thread
+    and any helper jobs. Helper jobs which start after the flush has
+    finished do nothing.
+*/
+struct SHAMap::FlushPass
+{
+    FlushPass (SHAMap& map_, NodeObjectType type_, std::uint32_t seq_)
+        : map (map_)
+        , type (type_)
+        , seq (seq_)
+        , next (0)
+        , threads (0)
+        , done (false)
+    {
+    }
+
+    // One group per branch of the root, and one for the root itself
+    enum
+    {
+        groupCount = 17
+    };
+
+    SHAMap& map;
+    NodeObjectType const type;
+    std::uint32_t const seq;
+    std::vector <SHAMapNode> groups [groupCount];
+
+    std::atomic <int> next;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    int threads;
+    bool done;
+    std::exception_ptr error;
+};
+
+/** Write all modified nodes to the node store
+
+    The nodes below each branch of the root form independent subtrees.
+    When there are enough of them, helper jobs serialize and store some
+    of the subtrees while the calling thread works on the rest. Nodes
+    are not written in any particular order.
+*/
 int SHAMap::flushDirty (DirtySet& set, int maxNodes, NodeObjectType t, std::uint32_t seq)
 {
+    ScopedWriteLockType sl (mLock);
+
+    std::shared_ptr <FlushPass> pass (std::make_shared <FlushPass> (*this, t, seq));
     int flushed = 0;
-    Serializer s;
 
-    ScopedWriteLockType sl (mLock);
+    for (DirtySet::iterator it = set.begin ();
+        (it != set.end ()) && (flushed < maxNodes); it = set.erase (it))
+    {
+        if (it->isRoot ())
+            pass->groups[FlushPass::groupCount - 1].push_back (*it);
+        else
+            pass->groups[SHAMapNode ().selectBranch (it->getNodeID ())].push_back (*it);
 
-    for (DirtySet::iterator it = set.begin (); it != set.end (); it = set.erase (it))
+        ++flushed;
+    }
+
+    int const helpers = std::min <int> (MAX_FLUSH_THREADS,
+        flushed / FLUSH_NODES_PER_THREAD) - 1;
+
+    for (int i = 0; i < helpers; ++i)
+        getApp().getJobQueue().addJob (jtFLUSH_HELPER, "SHAMap::helpFlush",
+            std::bind (&SHAMap::helpFlush, pass, std::placeholders::_1));
+
+    try
     {
-        SHAMapTreeNode::pointer node = checkCacheNode (*it);
+        flushGroups (*pass);
+    }
+    catch (...)
+    {
+        std::lock_guard <std::mutex> lock (pass->mutex);
+        if (!pass->error)
+            pass->error = std::current_exception ();
+    }
 
-        // Check if node was deleted
-        if (!node)
-            continue;
+    // No helper touches the map once the flush is done
+    std::unique_lock <std::mutex> lock (pass->mutex);
+    pass->done = true;
+    pass->cond.wait (lock, [&pass] { return pass->threads == 0; });
 
-        uint256 const nodeHash = node->getNodeHash();
+    if (pass->error)
+        std::rethrow_exception (pass->error);
 
-        s.erase ();
-        node->addRaw (s, snfPREFIX);
+    return flushed;
+}
 
-#ifdef BEAST_DEBUG
+void SHAMap::helpFlush (std::shared_ptr <FlushPass> const& pass, Job&)
+{
+    {
+        std::lock_guard <std::mutex> lock (pass->mutex);
+        if (pass->done)
+            return;
+        ++pass->threads;
+    }
 
-        if (s.getSHA512Half () != nodeHash)
-        {
-            WriteLog (lsFATAL, SHAMap) << *node;
-            WriteLog (lsFATAL, SHAMap) << beast::lexicalCast <std::string> (s.getDataLength ());
-            WriteLog (lsFATAL, SHAMap) << s.getSHA512Half () << " != " << nodeHash;
-            assert (false);
-        }
+    std::exception_ptr error;
 
-#endif
+    try
+    {
+        pass->map.flushGroups (*pass);
+    }
+    catch (...)
+    {
+        error = std::current_exception ();
+    }
 
-        if (node->getSeq () != 0)
-        {
-            // Node is not shareable
-            // Make and share a shareable copy
-            node = std::make_shared <SHAMapTreeNode> (*node, 0);
-            canonicalize (node->getNodeHash(), node);
-            mTNByID.replace (*node, node);
-        }
+    std::lock_guard <std::mutex> lock (pass->mutex);
+    if (error && !pass->error)
+        pass->error = error;
+    if (--pass->threads == 0)
+        pass->cond.notify_all ();
+}
+
+void SHAMap::flushGroups (FlushPass& pass)
+{
+    Serializer s;
 
-        getApp().getNodeStore ().store (t, seq, std::move (s.modData ()), nodeHash);
+    for (int group; (group = pass.next++) < FlushPass::groupCount; )
+    {
+        for (auto const& id : pass.groups[group])
+            flushDirtyNode (id, pass.type, pass.seq, s);
+    }
+}
+
+/** Serialize one dirty node and write it to the node store
+
+    The caller holds the write lock. This may run concurrently for
+    nodes in different subtrees, which is safe because the node
+    caches and the node store do their own locking.
+*/
+void SHAMap::flushDirtyNode (SHAMapNode const& id, NodeObjectType t,
+    std::uint32_t seq, Serializer& s)
+{
+    SHAMapTreeNode::pointer node = checkCacheNode (id);
+
+    // Check if node was deleted
+    if (!node)
+        return;
+
+    uint256 const nodeHash = node->getNodeHash();
+
+    s.erase ();
+    node->addRaw (s, snfPREFIX);
+
+#ifdef BEAST_DEBUG
 
-        if (flushed++ >= maxNodes)
-            return flushed;
+    if (s.getSHA512Half () != nodeHash)
+    {
+        WriteLog (lsFATAL, SHAMap) << *node;
+        WriteLog (lsFATAL, SHAMap) << beast::lexicalCast <std::string> (s.getDataLength ());
+        WriteLog (lsFATAL, SHAMap) << s.getSHA512Half () << " != " << nodeHash;
+        assert (false);
     }
 
-    return flushed;
+#endif
+
+    if (node->getSeq () != 0)
+    {
+        // Node is not shareable
+        // Make and share a shareable copy
+        node = SHAMapTreeNode::create (*node, 0);
+        canonicalize (node->getNodeHash(), node);
+        mTNByID.replace (*node, node);
+    }
+
+    getApp().getNodeStore ().store (t, seq, std::move (s.modData ()), nodeHash);
 }
 
 /** Stop saving dirty nodes */
@@ -1169,7 +1315,7 @@ SHAMapTreeNode::pointer SHAMap::getNode (const SHAMapNode& nodeID)
     if (node)
         return node;
 
-    node = root;
+    node = getRoot ();
 
     while (nodeID != *node)
     {
@@ -1198,7 +1344,8 @@ SHAMapTreeNode* SHAMap::getNodePointer (const SHAMapNode& nodeID)
         return ret;
     }
 
-    SHAMapTreeNode* node = root.get();
+    SHAMapTreeNode::pointer const rootNode (getRoot ());
+    SHAMapTreeNode* node = rootNode.get ();
 
     while (nodeID != *node)
     {
@@ -1223,9 +1370,11 @@ bool SHAMap::getPath (uint256 const& index, std::vector< Blob >& nodes, SHANodeF
     // Return the path of nodes to the specified index in the specified format
     // Return value: true = node present, false = node not present
 
+    // Holds raw node pointers, which dropCache could free
     ScopedReadLockType sl (mLock);
 
-    SHAMapTreeNode* inNode = root.get ();
+    SHAMapTreeNode::pointer const rootNode (getRoot ());
+    SHAMapTreeNode* inNode = rootNode.get ();
 
     while (!inNode->isLeaf ())
     {
@@ -1259,8 +1408,13 @@ void SHAMap::dropCache ()
 
     mTNByID.clear ();
 
-    if (root)
-        mTNByID.canonicalize(*root, &root);
+    SHAMapTreeNode::pointer node (getRoot ());
+
+    if (node)
+    {
+        mTNByID.canonicalize(*node, &node);
+        setRoot (node);
+    }
 }
 
 void SHAMap::dropBelow (SHAMapTreeNode* d)
@@ -1294,7 +1448,7 @@ SHAMapTreeNode::pointer SHAMap::getCache (uint256 const& hash, SHAMapNode const&
     {
         // We have the data, but with a different node ID
         WriteLog (lsTRACE, SHAMap) << "ID mismatch: " << id << " != " << *ret;
-        ret = std::make_shared <SHAMapTreeNode> (*ret, 0);
+        ret = SHAMapTreeNode::create (*ret, 0);
         ret->set(id);
 
         // Future fetches are likely to use the "new" ID
@@ -1317,7 +1471,7 @@ void SHAMap::canonicalize (uint256 const& hash, SHAMapTreeNode::pointer& node)
     if (id != *node)
     {
         // The cache has the node with a different ID
-        node = std::make_shared <SHAMapTreeNode> (*node, 0);
+        node = SHAMapTreeNode::create (*node, 0);
         node->set (id);
 
         // Future fetches are likely to use the newer ID
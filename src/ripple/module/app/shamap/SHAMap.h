@@ -101,7 +101,13 @@ private:
 public:
     enum
     {
-        STATE_MAP_BUCKETS = 1024
+        STATE_MAP_BUCKETS = 1024,
+
+        // Smallest share of a flush worth handing to its own thread
+        FLUSH_NODES_PER_THREAD = 64,
+
+        // Most threads, including the caller, which work on one flush
+        MAX_FLUSH_THREADS = 4
     };
 
     static char const* getCountedObjectName () { return "SHAMap"; }
@@ -156,11 +162,11 @@ public:
     SHAMapItem getItem (uint256 const & id);
     uint256 getHash () const
     {
-        return root->getNodeHash ();
+        return getRoot ()->getNodeHash ();
     }
     uint256 getHash ()
     {
-        return root->getNodeHash ();
+        return getRoot ()->getNodeHash ();
     }
 
     // save a copy if you have a temporary anyway
@@ -188,11 +194,11 @@ public:
                      std::list<Blob >& rawNode, bool fatRoot, bool fatLeaves);
     bool getRootNode (Serializer & s, SHANodeFormat format);
     std::vector<uint256> getNeededHashes (int max, SHAMapSyncFilter * filter);
-    SHAMapAddNode addRootNode (uint256 const & hash, Blob const & rootNode, SHANodeFormat format,
+    SHAMapAddNode addRootNode (uint256 const & hash, const_byte_view rootNode, SHANodeFormat format,
                                SHAMapSyncFilter * filter);
-    SHAMapAddNode addRootNode (Blob const & rootNode, SHANodeFormat format,
+    SHAMapAddNode addRootNode (const_byte_view rootNode, SHANodeFormat format,
                                SHAMapSyncFilter * filter);
-    SHAMapAddNode addKnownNode (const SHAMapNode & nodeID, Blob const & rawNode,
+    SHAMapAddNode addKnownNode (const SHAMapNode & nodeID, const_byte_view rawNode,
                                 SHAMapSyncFilter * filter);
 
     // status functions
@@ -219,7 +225,13 @@ public:
     }
     void clearSynching ()
     {
-        mState = smsModifying;
+        // An immutable map stays immutable, readers rely on it
+        SHAMapState expected (smsSynching);
+        if (! mState.compare_exchange_strong (expected, smsModifying) &&
+            (expected != smsImmutable))
+        {
+            mState = smsModifying;
+        }
     }
     bool isValid ()
     {
@@ -303,13 +315,42 @@ public:
     typedef std::pair<uint256, SHAMapNode> TNIndex;
 
 private:
-    static TaggedCache <uint256, SHAMapTreeNode> treeNodeCache;
+    // Shared by every map, so sharded to reduce lock contention
+    static ShardedTaggedCache <uint256, SHAMapTreeNode> treeNodeCache;
+
+    // Readers of an immutable map take no lock, since nothing may change
+    // it. Walks which hold raw node pointers must still take mLock, because
+    // dropCache empties the node index of an immutable map under the write
+    // lock and that can free the nodes they point to.
+    ScopedReadLockType lockForRead () const
+    {
+        if (mState == smsImmutable)
+            return ScopedReadLockType ();
+        return ScopedReadLockType (mLock);
+    }
+
+    // A fetch may replace the root while other threads read it, with only
+    // a read lock or none, so the root is always loaded and stored atomically.
+    SHAMapTreeNode::pointer getRoot () const
+    {
+        return std::atomic_load (&root);
+    }
+    void setRoot (SHAMapTreeNode::ref node)
+    {
+        std::atomic_store (&root, node);
+    }
 
     void dirtyUp (std::stack<SHAMapTreeNode::pointer>& stack, uint256 const & target, uint256 prevHash);
     std::stack<SHAMapTreeNode::pointer> getStack (uint256 const & id, bool include_nonmatching_leaf);
     SHAMapTreeNode::pointer walkTo (uint256 const & id, bool modify);
-    SHAMapTreeNode* walkToPointer (uint256 const & id);
+    SHAMapTreeNode::pointer walkToLeaf (uint256 const & id);
+    SHAMapTreeNode::pointer descend (SHAMapTreeNode* parent, int branch);
     SHAMapTreeNode::pointer checkCacheNode (const SHAMapNode&);
+    struct FlushPass;
+    static void helpFlush (std::shared_ptr <FlushPass> const& pass, Job&);
+    void flushGroups (FlushPass& pass);
+    void flushDirtyNode (SHAMapNode const& id, NodeObjectType t,
+        std::uint32_t seq, Serializer& s);
     void returnNode (SHAMapTreeNode::pointer&, bool modify);
     void trackNewNode (SHAMapTreeNode::pointer&);
 
@@ -320,14 +361,14 @@ private:
     SHAMapTreeNode* getNodePointerNT (const SHAMapNode & id, uint256 const & hash);
     SHAMapTreeNode* getNodePointer (const SHAMapNode & id, uint256 const & hash, SHAMapSyncFilter * filter);
     SHAMapTreeNode* getNodePointerNT (const SHAMapNode & id, uint256 const & hash, SHAMapSyncFilter * filter);
-    SHAMapTreeNode* firstBelow (SHAMapTreeNode*);
-    SHAMapTreeNode* lastBelow (SHAMapTreeNode*);
+    SHAMapTreeNode::pointer firstBelow (SHAMapTreeNode::pointer);
+    SHAMapTreeNode::pointer lastBelow (SHAMapTreeNode::pointer);
 
     // Non-blocking version of getNodePointerNT
     SHAMapTreeNode* getNodeAsync (
         const SHAMapNode & id, uint256 const & hash, SHAMapSyncFilter * filter, bool& pending);
 
-    SHAMapItem::pointer onlyBelow (SHAMapTreeNode*);
+    SHAMapItem::pointer onlyBelow (SHAMapTreeNode::pointer);
     void eraseChildren (SHAMapTreeNode::pointer);
     void dropBelow (SHAMapTreeNode*);
     bool hasInnerNode (const SHAMapNode & nodeID, uint256 const & hash);
@@ -343,6 +384,7 @@ private:
     // This lock protects key SHAMap structures.
     // One may change anything with a write lock.
     // With a read lock, one may not invalidate pointers to existing members of mTNByID
+    // Once a map is immutable, readers no longer take it.
     mutable LockType mLock;
 
     FullBelowCache& m_fullBelowCache;
@@ -351,7 +393,7 @@ private:
     SyncUnorderedMapType< SHAMapNode, SHAMapTreeNode::pointer, SHAMapNode_hash > mTNByID;
     std::shared_ptr<DirtySet> mDirtyNodes;
     SHAMapTreeNode::pointer root;
-    SHAMapState mState;
+    std::atomic <SHAMapState> mState;
     SHAMapType mType;
     bool mTXMap;       // Map of transactions without metadata
     MissingNodeHandler m_missing_node_handler;
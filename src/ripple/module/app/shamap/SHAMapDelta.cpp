@@ -140,6 +140,7 @@ bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount)
 
     std::stack<SHAMapDeltaNode> nodeStack; // track nodes we've pushed
 
+    // Holds raw node pointers, which dropCache could free
     ScopedReadLockType sl (mLock);
 
     if (getHash () == otherMap->getHash ())
@@ -238,12 +239,14 @@ void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissi
 {
     std::stack<SHAMapTreeNode::pointer> nodeStack;
 
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
+
+    SHAMapTreeNode::pointer const rootNode (getRoot ());
 
-    if (!root->isInner ())  // root is only node, and we have it
+    if (!rootNode->isInner ())  // root is only node, and we have it
         return;
 
-    nodeStack.push (root);
+    nodeStack.push (rootNode);
 
     while (!nodeStack.empty ())
     {
@@ -33,4 +33,11 @@ SHAMapItem::SHAMapItem (uint256 const& tag, const Serializer& data)
 {
 }
 
+SHAMapItem::SHAMapItem (uint256 const& tag, void const* data, std::size_t size)
+    : mTag (tag)
+    , mData (size)
+{
+    mData.addRaw (data, size);
+}
+
 } // ripple
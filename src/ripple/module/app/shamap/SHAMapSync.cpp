@@ -34,21 +34,22 @@ void SHAMap::visitLeaves (std::function<void (SHAMapItem::ref item)> function)
 
 void SHAMap::visitLeavesInternal (std::function<void (SHAMapItem::ref item)>& function)
 {
-    assert (root->isValid ());
+    SHAMapTreeNode::pointer node = getRoot ();
 
-    if (!root || root->isEmpty ())
+    assert (node->isValid ());
+
+    if (!node || node->isEmpty ())
         return;
 
-    if (!root->isInner ())
+    if (!node->isInner ())
     {
-        function (root->peekItem ());
+        function (node->peekItem ());
         return;
     }
 
-    typedef std::pair<int, SHAMapTreeNode*> posPair;
+    typedef std::pair<int, SHAMapTreeNode::pointer> posPair;
 
     std::stack<posPair> stack;
-    SHAMapTreeNode* node = root.get ();
     int pos = 0;
 
     while (1)
@@ -61,7 +62,7 @@ void SHAMap::visitLeavesInternal (std::function<void (SHAMapItem::ref item)>& fu
             }
             else
             {
-                SHAMapTreeNode* child = getNodePointer (node->getChildNodeID (pos), node->getChildHash (pos));
+                SHAMapTreeNode::pointer child = descend (node.get (), pos);
                 if (child->isLeaf ())
                 {
                     function (child->peekItem ());
@@ -118,19 +119,23 @@ public:
 void SHAMap::getMissingNodes (std::vector<SHAMapNode>& nodeIDs, std::vector<uint256>& hashes, int max,
                               SHAMapSyncFilter* filter)
 {
+    // Holds raw node pointers, which dropCache could free
     ScopedReadLockType sl (mLock);
 
-    assert (root->isValid ());
-    assert (root->getNodeHash().isNonZero ());
+    // A fetch may replace the root, so keep this one alive
+    SHAMapTreeNode::pointer const rootNode (getRoot ());
+
+    assert (rootNode->isValid ());
+    assert (rootNode->getNodeHash().isNonZero ());
 
 
-    if (root->isFullBelow ())
+    if (rootNode->isFullBelow ())
     {
         clearSynching ();
         return;
     }
 
-    if (!root->isInner ())
+    if (!rootNode->isInner ())
     {
         WriteLog (lsWARNING, SHAMap) << "synching empty tree";
         return;
@@ -151,7 +156,7 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNode>& nodeIDs, std::vector<uint
 
         // Traverse the map without blocking
 
-        SHAMapTreeNode *node = root.get ();
+        SHAMapTreeNode *node = rootNode.get ();
         int firstChild = rand() % 256;
         int currentChild = 0;
         bool fullBelow = true;
@@ -234,7 +239,17 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNode>& nodeIDs, std::vector<uint
         if (deferredReads.empty ())
             break;
 
-        getApp().getNodeStore().waitReads();
+        {
+            // Read all the deferred nodes with as few backend requests
+            // as possible instead of waiting for them to be prefetched
+            std::vector <uint256> deferredHashes;
+            deferredHashes.reserve (deferredReads.size ());
+
+            for (auto const& node : deferredReads)
+                deferredHashes.push_back (node.second);
+
+            getApp().getNodeStore().fetchBatch (deferredHashes);
+        }
 
         // Process all deferred reads
         for (auto const& node : deferredReads)
@@ -274,6 +289,7 @@ bool SHAMap::getNodeFat (const SHAMapNode& wanted, std::vector<SHAMapNode>& node
                          std::list<Blob >& rawNodes, bool fatRoot, bool fatLeaves)
 {
     // Gets a node and some of its children
+    // Holds raw node pointers, which dropCache could free
     ScopedReadLockType sl (mLock);
 
     SHAMapTreeNode* node = getNodePointer(wanted);
@@ -336,18 +352,18 @@ bool SHAMap::getNodeFat (const SHAMapNode& wanted, std::vector<SHAMapNode>& node
 
 bool SHAMap::getRootNode (Serializer& s, SHANodeFormat format)
 {
-    ScopedReadLockType sl (mLock);
-    root->addRaw (s, format);
+    ScopedReadLockType sl (lockForRead ());
+    getRoot ()->addRaw (s, format);
     return true;
 }
 
-SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode, SHANodeFormat format,
+SHAMapAddNode SHAMap::addRootNode (const_byte_view rootNode, SHANodeFormat format,
                                    SHAMapSyncFilter* filter)
 {
     ScopedWriteLockType sl (mLock);
 
     // we already have a root node
-    if (root->getNodeHash ().isNonZero ())
+    if (getRoot ()->getNodeHash ().isNonZero ())
     {
         WriteLog (lsTRACE, SHAMap) << "got root node, already have one";
         return SHAMapAddNode::duplicate ();
@@ -355,7 +371,7 @@ SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode, SHANodeFormat format,
 
     assert (mSeq >= 1);
     SHAMapTreeNode::pointer node =
-        std::make_shared<SHAMapTreeNode> (SHAMapNode (), rootNode, mSeq - 1, format, uZero, false);
+        SHAMapTreeNode::create (SHAMapNode (), rootNode, mSeq - 1, format, uZero, false);
 
     if (!node)
         return SHAMapAddNode::invalid ();
@@ -364,59 +380,59 @@ SHAMapAddNode SHAMap::addRootNode (Blob const& rootNode, SHANodeFormat format,
     node->dump ();
 #endif
 
-    root = node;
-    mTNByID.replace(*root, root);
+    setRoot (node);
+    mTNByID.replace(*node, node);
 
-    if (root->isLeaf())
+    if (node->isLeaf())
         clearSynching ();
 
     if (filter)
     {
         Serializer s;
-        root->addRaw (s, snfPREFIX);
-        filter->gotNode (false, *root, root->getNodeHash (), s.modData (), root->getType ());
+        node->addRaw (s, snfPREFIX);
+        filter->gotNode (false, *node, node->getNodeHash (), s.modData (), node->getType ());
     }
 
     return SHAMapAddNode::useful ();
 }
 
-SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, Blob const& rootNode, SHANodeFormat format,
+SHAMapAddNode SHAMap::addRootNode (uint256 const& hash, const_byte_view rootNode, SHANodeFormat format,
                                    SHAMapSyncFilter* filter)
 {
     ScopedWriteLockType sl (mLock);
 
     // we already have a root node
-    if (root->getNodeHash ().isNonZero ())
+    if (getRoot ()->getNodeHash ().isNonZero ())
     {
         WriteLog (lsTRACE, SHAMap) << "got root node, already have one";
-        assert (root->getNodeHash () == hash);
+        assert (getRoot ()->getNodeHash () == hash);
         return SHAMapAddNode::duplicate ();
     }
 
     assert (mSeq >= 1);
     SHAMapTreeNode::pointer node =
-        std::make_shared<SHAMapTreeNode> (SHAMapNode (), rootNode, mSeq - 1, format, uZero, false);
+        SHAMapTreeNode::create (SHAMapNode (), rootNode, mSeq - 1, format, uZero, false);
 
     if (!node || node->getNodeHash () != hash)
         return SHAMapAddNode::invalid ();
 
-    root = node;
-    mTNByID.replace(*root, root);
+    setRoot (node);
+    mTNByID.replace(*node, node);
 
-    if (root->isLeaf())
+    if (node->isLeaf())
         clearSynching ();
 
     if (filter)
     {
         Serializer s;
-        root->addRaw (s, snfPREFIX);
-        filter->gotNode (false, *root, root->getNodeHash (), s.modData (), root->getType ());
+        node->addRaw (s, snfPREFIX);
+        filter->gotNode (false, *node, node->getNodeHash (), s.modData (), node->getType ());
     }
 
     return SHAMapAddNode::useful ();
 }
 
-SHAMapAddNode SHAMap::addKnownNode (const SHAMapNode& node, Blob const& rawNode, SHAMapSyncFilter* filter)
+SHAMapAddNode SHAMap::addKnownNode (const SHAMapNode& node, const_byte_view rawNode, SHAMapSyncFilter* filter)
 {
     ScopedWriteLockType sl (mLock);
 
@@ -433,7 +449,9 @@ SHAMapAddNode SHAMap::addKnownNode (const SHAMapNode& node, Blob const& rawNode,
         return SHAMapAddNode::duplicate ();
 
     SHAMapTreeNode::pointer parent = checkCacheNode(node.getParentNodeID());
-    SHAMapTreeNode* iNode = parent ? parent.get() : root.get ();
+    if (!parent)
+        parent = getRoot ();
+    SHAMapTreeNode* iNode = parent.get ();
 
     while (!iNode->isLeaf () && !iNode->isFullBelow () && (iNode->getDepth () < node.getDepth ()))
     {
@@ -462,7 +480,7 @@ SHAMapAddNode SHAMap::addKnownNode (const SHAMapNode& node, Blob const& rawNode,
             }
 
             SHAMapTreeNode::pointer newNode =
-                std::make_shared<SHAMapTreeNode> (node, rawNode, 0, snfWIRE, uZero, false);
+                SHAMapTreeNode::create (node, rawNode, 0, snfWIRE, uZero, false);
 
             if (iNode->getChildHash (branch) != newNode->getNodeHash ())
             {
@@ -499,9 +517,9 @@ bool SHAMap::deepCompare (SHAMap& other)
 {
     // Intended for debug/test only
     std::stack<SHAMapTreeNode::pointer> stack;
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
-    stack.push (root);
+    stack.push (getRoot ());
 
     while (!stack.empty ())
     {
@@ -510,7 +528,7 @@ bool SHAMap::deepCompare (SHAMap& other)
 
         SHAMapTreeNode::pointer otherNode;
 
-        if (node->isRoot ()) otherNode = other.root;
+        if (node->isRoot ()) otherNode = other.getRoot ();
         else otherNode = other.getNode (*node, node->getNodeHash (), false);
 
         if (!otherNode)
@@ -576,7 +594,8 @@ bool SHAMap::hasInnerNode (const SHAMapNode& nodeID, uint256 const& nodeHash)
     if (ptr)
         return ptr->getNodeHash() == nodeHash;
 
-    SHAMapTreeNode* node = root.get ();
+    SHAMapTreeNode::pointer const rootNode (getRoot ());
+    SHAMapTreeNode* node = rootNode.get ();
 
     while (node->isInner () && (node->getDepth () < nodeID.getDepth ()))
     {
@@ -596,7 +615,8 @@ bool SHAMap::hasInnerNode (const SHAMapNode& nodeID, uint256 const& nodeHash)
 */
 bool SHAMap::hasLeafNode (uint256 const& tag, uint256 const& nodeHash)
 {
-    SHAMapTreeNode* node = root.get ();
+    SHAMapTreeNode::pointer const rootNode (getRoot ());
+    SHAMapTreeNode* node = rootNode.get ();
 
     if (!node->isInner()) // only one leaf node in the tree
         return node->getNodeHash() == nodeHash;
@@ -651,20 +671,23 @@ void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
     }
 
 
-    if (root->getNodeHash ().isZero ())
+    // A fetch may replace the root, so keep this one alive
+    SHAMapTreeNode::pointer const rootNode (getRoot ());
+
+    if (rootNode->getNodeHash ().isZero ())
         return;
 
-    if (have && (root->getNodeHash () == have->root->getNodeHash ()))
+    if (have && (rootNode->getNodeHash () == have->getRoot ()->getNodeHash ()))
         return;
 
-    if (root->isLeaf ())
+    if (rootNode->isLeaf ())
     {
         if (includeLeaves &&
-                (!have || !have->hasLeafNode (root->getTag (), root->getNodeHash ())))
+                (!have || !have->hasLeafNode (rootNode->getTag (), rootNode->getNodeHash ())))
         {
             Serializer s;
-            root->addRaw (s, snfPREFIX);
-            func (boost::cref(root->getNodeHash ()), boost::cref(s.peekData ()));
+            rootNode->addRaw (s, snfPREFIX);
+            func (boost::cref(rootNode->getNodeHash ()), boost::cref(s.peekData ()));
             --max;
         }
 
@@ -672,7 +695,7 @@ void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
     }
 
     std::stack<SHAMapTreeNode*> stack; // contains unexplored non-matching inner node entries
-    stack.push (root.get());
+    stack.push (rootNode.get());
 
     while (!stack.empty() && (max > 0))
     {
@@ -714,7 +737,7 @@ void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
 
 std::list<Blob > SHAMap::getTrustedPath (uint256 const& index)
 {
-    ScopedReadLockType sl (mLock);
+    ScopedReadLockType sl (lockForRead ());
 
     std::stack<SHAMapTreeNode::pointer> stack = SHAMap::getStack (index, false);
 
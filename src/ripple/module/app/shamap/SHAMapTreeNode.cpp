@@ -22,6 +22,7 @@ namespace ripple {
 SHAMapTreeNode::SHAMapTreeNode (std::uint32_t seq, const SHAMapNode& nodeID)
     : SHAMapNode (nodeID)
     , mHash (std::uint64_t(0))
+    , mInner (nullptr)
     , mSeq (seq)
     , mAccessSeq (seq)
     , mType (tnERROR)
@@ -31,46 +32,65 @@ SHAMapTreeNode::SHAMapTreeNode (std::uint32_t seq, const SHAMapNode& nodeID)
 }
 
 SHAMapTreeNode::SHAMapTreeNode (const SHAMapTreeNode& node, std::uint32_t seq) : SHAMapNode (node),
-    mHash (node.mHash), mSeq (seq), mType (node.mType), mIsBranch (node.mIsBranch), mFullBelow (false)
+    mHash (node.mHash), mInner (nullptr), mSeq (seq), mType (node.mType), mIsBranch (node.mIsBranch), mFullBelow (false)
 {
     if (node.mItem)
         mItem = node.mItem;
-    else
-        memcpy (mHashes, node.mHashes, sizeof (mHashes));
+    else if (node.mInner != nullptr)
+    {
+        allocateInner ();
+        memcpy (mInner->hashes, node.mInner->hashes, sizeof (mInner->hashes));
+
+        beast::SpinLock::ScopedLockType lock (node.mInner->lock);
+        if (node.mInner->children != nullptr)
+            mInner->children = new Children (*node.mInner->children);
+    }
 }
 
 SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& node, SHAMapItem::ref item,
                                 TNType type, std::uint32_t seq) :
-    SHAMapNode (node), mItem (item), mSeq (seq), mType (type), mIsBranch (0), mFullBelow (false)
+    SHAMapNode (node), mInner (nullptr), mItem (item), mSeq (seq), mType (type), mIsBranch (0), mFullBelow (false)
 {
     assert (item->peekData ().size () >= 12);
     updateHash ();
 }
 
-SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::uint32_t seq,
+// Read the 256-bit hash which starts at the specified offset.
+static uint256 getRawHash (const_byte_view data, std::size_t offset)
+{
+    uint256 ret;
+    memcpy (ret.begin (), data.data () + offset, 256 / 8);
+    return ret;
+}
+
+// The node is parsed in place, so a node received from a peer is only
+// copied once, into the item it creates.
+SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, const_byte_view rawNode, std::uint32_t seq,
                                 SHANodeFormat format, uint256 const& hash, bool hashValid) :
-    SHAMapNode (id), mSeq (seq), mType (tnERROR), mIsBranch (0), mFullBelow (false)
+    SHAMapNode (id), mInner (nullptr), mSeq (seq), mType (tnERROR), mIsBranch (0), mFullBelow (false)
 {
     if (format == snfWIRE)
     {
-        Serializer s (rawNode);
-        int type = s.removeLastByte ();
-        int len = s.getLength ();
+        int type = rawNode.empty () ? -1 : rawNode.back ();
 
         if ((type < 0) || (type > 4))
         {
 #ifdef BEAST_DEBUG
             Log::out() << "Invalid wire format node";
-            Log::out() << strHex (rawNode);
+            Log::out() << strHex (rawNode.data (), rawNode.size ());
             assert (false);
 #endif
             throw std::runtime_error ("invalid node AW type");
         }
 
+        const_byte_view s (rawNode.data (), rawNode.size () - 1);
+        int len = s.size ();
+
         if (type == 0)
         {
             // transaction
-            mItem = std::make_shared<SHAMapItem> (s.getPrefixHash (HashPrefix::transactionID), s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (
+                Serializer::getPrefixHash (HashPrefix::transactionID, s.data (), len), s.data (), len);
             mType = tnTRANSACTION_NM;
         }
         else if (type == 1)
@@ -79,13 +99,11 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::
             if (len < (256 / 8))
                 throw std::runtime_error ("short AS node");
 
-            uint256 u;
-            s.get256 (u, len - (256 / 8));
-            s.chop (256 / 8);
+            uint256 u = getRawHash (s, len - (256 / 8));
 
             if (u.isZero ()) throw std::runtime_error ("invalid AS node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, s.data (), len - (256 / 8));
             mType = tnACCOUNT_STATE;
         }
         else if (type == 2)
@@ -94,11 +112,13 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::
             if (len != 512)
                 throw std::runtime_error ("invalid FI node");
 
+            allocateInner ();
+
             for (int i = 0; i < 16; ++i)
             {
-                s.get256 (mHashes[i], i * 32);
+                mInner->hashes[i] = getRawHash (s, i * 32);
 
-                if (mHashes[i].isNonZero ())
+                if (mInner->hashes[i].isNonZero ())
                     mIsBranch |= (1 << i);
             }
 
@@ -107,16 +127,17 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::
         else if (type == 3)
         {
             // compressed inner
+            allocateInner ();
+
             for (int i = 0; i < (len / 33); ++i)
             {
-                int pos;
-                s.get8 (pos, 32 + (i * 33));
+                int pos = s[32 + (i * 33)];
 
                 if ((pos < 0) || (pos >= 16)) throw std::runtime_error ("invalid CI node");
 
-                s.get256 (mHashes[pos], i * 33);
+                mInner->hashes[pos] = getRawHash (s, i * 33);
 
-                if (mHashes[pos].isNonZero ())
+                if (mInner->hashes[pos].isNonZero ())
                     mIsBranch |= (1 << pos);
             }
 
@@ -128,14 +149,12 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::
             if (len < (256 / 8))
                 throw std::runtime_error ("short TM node");
 
-            uint256 u;
-            s.get256 (u, len - (256 / 8));
-            s.chop (256 / 8);
+            uint256 u = getRawHash (s, len - (256 / 8));
 
             if (u.isZero ())
                 throw std::runtime_error ("invalid TM node");
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, s.data (), len - (256 / 8));
             mType = tnTRANSACTION_MD;
         }
     }
@@ -155,21 +174,19 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::
         prefix |= rawNode[2];
         prefix <<= 8;
         prefix |= rawNode[3];
-        Serializer s (rawNode.begin () + 4, rawNode.end ());
+        const_byte_view s (rawNode.data () + 4, rawNode.size () - 4);
 
         if (prefix == HashPrefix::transactionID)
         {
-            mItem = std::make_shared<SHAMapItem> (Serializer::getSHA512Half (rawNode), s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (Serializer::getSHA512Half (rawNode), s.data (), s.size ());
             mType = tnTRANSACTION_NM;
         }
         else if (prefix == HashPrefix::leafNode)
         {
-            if (s.getLength () < 32)
+            if (s.size () < 32)
                 throw std::runtime_error ("short PLN node");
 
-            uint256 u;
-            s.get256 (u, s.getLength () - 32);
-            s.chop (32);
+            uint256 u = getRawHash (s, s.size () - 32);
 
             if (u.isZero ())
             {
@@ -177,19 +194,21 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::
                 throw std::runtime_error ("invalid PLN node");
             }
 
-            mItem = std::make_shared<SHAMapItem> (u, s.peekData ());
+            mItem = std::make_shared<SHAMapItem> (u, s.data (), s.size () - 32);
             mType = tnACCOUNT_STATE;
         }
         else if (prefix == HashPrefix::innerNode)
         {
-            if (s.getLength () != 512)
+            if (s.size () != 512)
                 throw std::runtime_error ("invalid PIN node");
 
+            allocateInner ();
+
             for (int i = 0; i < 16; ++i)
             {
-                s.get256 (mHashes[i], i * 32);
+                mInner->hashes[i] = getRawHash (s, i * 32);
 
-                if (mHashes[i].isNonZero ())
+                if (mInner->hashes[i].isNonZero ())
                     mIsBranch |= (1 << i);
             }
 
@@ -198,13 +217,11 @@ SHAMapTreeNode::SHAMapTreeNode (const SHAMapNode& id, Blob const& rawNode, std::
         else if (prefix == HashPrefix::txNode)
         {
             // transaction with metadata
-            if (s.getLength () < 32)
+            if (s.size () < 32)
                 throw std::runtime_error ("short TXN node");
 
-            uint256 txID;
-            s.get256 (txID, s.getLength () - 32);
-            s.chop (32);
-            mItem = std::make_shared<SHAMapItem> (txID, s.peekData ());
+            uint256 txID = getRawHash (s, s.size () - 32);
+            mItem = std::make_shared<SHAMapItem> (txID, s.data (), s.size () - 32);
             mType = tnTRANSACTION_MD;
         }
         else
@@ -240,13 +257,13 @@ bool SHAMapTreeNode::updateHash ()
     {
         if (mIsBranch != 0)
         {
-            nh = Serializer::getPrefixHash (HashPrefix::innerNode, reinterpret_cast<unsigned char*> (mHashes), sizeof (mHashes));
+            nh = Serializer::getPrefixHash (HashPrefix::innerNode, reinterpret_cast<unsigned char*> (mInner->hashes), sizeof (mInner->hashes));
 #if RIPPLE_VERIFY_NODEOBJECT_KEYS
             Serializer s;
             s.add32 (HashPrefix::innerNode);
 
             for (int i = 0; i < 16; ++i)
-                s.add256 (mHashes[i]);
+                s.add256 (mInner->hashes[i]);
 
             assert (nh == s.getSHA512Half ());
 #endif
@@ -304,7 +321,7 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
             s.add32 (HashPrefix::innerNode);
 
             for (int i = 0; i < 16; ++i)
-                s.add256 (mHashes[i]);
+                s.add256 (mInner->hashes[i]);
         }
         else
         {
@@ -314,7 +331,7 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
                 for (int i = 0; i < 16; ++i)
                     if (!isEmptyBranch (i))
                     {
-                        s.add256 (mHashes[i]);
+                        s.add256 (mInner->hashes[i]);
                         s.add8 (i);
                     }
 
@@ -323,7 +340,7 @@ void SHAMapTreeNode::addRaw (Serializer& s, SHANodeFormat format)
             else
             {
                 for (int i = 0; i < 16; ++i)
-                    s.add256 (mHashes[i]);
+                    s.add256 (mInner->hashes[i]);
 
                 s.add8 (2);
             }
@@ -380,6 +397,7 @@ bool SHAMapTreeNode::setItem (SHAMapItem::ref i, TNType type)
 {
     mType = type;
     mItem = i;
+    freeInner ();
     assert (isLeaf ());
     assert (mSeq != 0);
     return updateHash ();
@@ -406,7 +424,8 @@ void SHAMapTreeNode::makeInner ()
 {
     mItem.reset ();
     mIsBranch = 0;
-    memset (mHashes, 0, sizeof (mHashes));
+    freeInner ();
+    allocateInner ();
     mType = tnINNER;
     mHash.zero ();
 }
@@ -432,7 +451,7 @@ std::string SHAMapTreeNode::getString () const
                 ret += "\nb";
                 ret += beast::lexicalCastThrow <std::string> (i);
                 ret += " = ";
-                ret += to_string (mHashes[i]);
+                ret += to_string (mInner->hashes[i]);
             }
     }
 
@@ -458,16 +477,81 @@ std::string SHAMapTreeNode::getString () const
     return ret;
 }
 
+SHAMapTreeNode::~SHAMapTreeNode ()
+{
+    freeInner ();
+}
+
+SlabAllocator& SHAMapTreeNode::getInnerAllocator ()
+{
+    // Never destroyed, since cached nodes may outlive static destruction
+    static SlabAllocator* allocator (new SlabAllocator (sizeof (Inner)));
+    return *allocator;
+}
+
+void SHAMapTreeNode::allocateInner ()
+{
+    // The hashes are constructed as zero
+    if (mInner == nullptr)
+        mInner = new (getInnerAllocator ().allocate ()) Inner;
+}
+
+void SHAMapTreeNode::freeInner ()
+{
+    if (mInner != nullptr)
+    {
+        mInner->~Inner ();
+        getInnerAllocator ().deallocate (mInner);
+        mInner = nullptr;
+    }
+}
+
+SHAMapTreeNode::pointer SHAMapTreeNode::getChild (int m) const
+{
+    assert ((m >= 0) && (m < 16) && (mType == tnINNER));
+
+    pointer child;
+    {
+        beast::SpinLock::ScopedLockType lock (mInner->lock);
+        if (mInner->children != nullptr)
+            child = mInner->children->nodes[m].lock ();
+    }
+
+    // A node whose hash changed is no longer our child
+    if (child && (child->getNodeHash () != mInner->hashes[m]))
+        child.reset ();
+
+    return child;
+}
+
+void SHAMapTreeNode::setChild (int m, ref child)
+{
+    assert ((m >= 0) && (m < 16) && (mType == tnINNER));
+    assert (child->getSeq () == 0);
+    assert (child->getNodeHash () == mInner->hashes[m]);
+
+    beast::SpinLock::ScopedLockType lock (mInner->lock);
+    if (mInner->children == nullptr)
+        mInner->children = new Children;
+    mInner->children->nodes[m] = child;
+}
+
 bool SHAMapTreeNode::setChildHash (int m, uint256 const& hash)
 {
     assert ((m >= 0) && (m < 16));
     assert (mType == tnINNER);
     assert (mSeq != 0);
 
-    if (mHashes[m] == hash)
+    if (mInner->hashes[m] == hash)
         return false;
 
-    mHashes[m] = hash;
+    mInner->hashes[m] = hash;
+
+    {
+        beast::SpinLock::ScopedLockType lock (mInner->lock);
+        if (mInner->children != nullptr)
+            mInner->children->nodes[m].reset ();
+    }
 
     if (hash.isNonZero ())
         mIsBranch |= (1 << m);
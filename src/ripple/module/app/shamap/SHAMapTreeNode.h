@@ -51,14 +51,27 @@ public:
     };
 
 public:
+    /** Create a node.
+
+        The node shares one allocation with its reference count. A parent's
+        cached weak pointer keeps that block alive after the node is
+        evicted, but only until the cache entry is next replaced.
+    */
+    template <class... Args>
+    static pointer create (Args&&... args)
+    {
+        return std::make_shared <SHAMapTreeNode> (std::forward <Args> (args)...);
+    }
+
     SHAMapTreeNode (std::uint32_t seq, const SHAMapNode & nodeID); // empty node
     SHAMapTreeNode (const SHAMapTreeNode & node, std::uint32_t seq); // copy node from older tree
     SHAMapTreeNode (const SHAMapNode & nodeID, SHAMapItem::ref item, TNType type,
                     std::uint32_t seq);
 
     // raw node functions
-    SHAMapTreeNode (const SHAMapNode & id, Blob const & data, std::uint32_t seq,
+    SHAMapTreeNode (const SHAMapNode & id, const_byte_view data, std::uint32_t seq,
                     SHANodeFormat format, uint256 const & hash, bool hashValid);
+    ~SHAMapTreeNode ();
     void addRaw (Serializer&, SHANodeFormat format);
 
     virtual bool isPopulated () const
@@ -137,9 +150,17 @@ public:
     uint256 const& getChildHash (int m) const
     {
         assert ((m >= 0) && (m < 16) && (mType == tnINNER));
-        return mHashes[m];
+        return mInner->hashes[m];
     }
 
+    // Returns the child on a branch if a pointer to it is cached and the
+    // child still has the hash this node links to, otherwise null.
+    pointer getChild (int m) const;
+
+    // Caches a pointer to an immutable child, so later walks through this
+    // node can descend without looking the child up.
+    void setChild (int m, ref child);
+
     // item node function
     bool hasItem () const
     {
@@ -180,8 +201,36 @@ private:
     // VFALCO TODO remove the use of friend
     friend class SHAMap;
 
+    // Cached pointers to children, allocated the first time a read walk
+    // descends through the node, so nodes nobody walks pay one pointer.
+    struct Children
+    {
+        std::weak_ptr <SHAMapTreeNode> nodes[16];
+    };
+
+    // The parts only inner nodes use. They are kept in a separate
+    // pooled block rather than in every leaf.
+    struct Inner
+    {
+        Inner () : children (nullptr)
+        {
+        }
+
+        ~Inner ()
+        {
+            delete children;
+        }
+
+        uint256 hashes[16];
+
+        // Guards children, which may be read by every map sharing the node
+        beast::SpinLock lock;
+        Children* children;
+    };
+
     uint256             mHash;
-    uint256             mHashes[16];
+    Inner*              mInner;
+
     SHAMapItem::pointer mItem;
     std::uint32_t       mSeq, mAccessSeq;
     TNType              mType;
@@ -189,6 +238,11 @@ private:
     bool                mFullBelow;
 
     bool updateHash ();
+
+    void allocateInner ();
+    void freeInner ();
+
+    static SlabAllocator& getInnerAllocator ();
 };
 
 } // ripple
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace ripple {
+
+class SigVerifierImp : public SigVerifier
+{
+private:
+    enum
+    {
+        // Most transactions taken from the queue at once
+        batchSize = 64,
+
+        // Most batches one job checks before it requeues itself, so
+        // a flood of transactions cannot hold a worker indefinitely
+        batchesPerJob = 4
+    };
+
+    struct Entry
+    {
+        Entry (SerializedTransaction::ref txn_, Handler&& handler_)
+            : txn (txn_)
+            , handler (std::move (handler_))
+        {
+        }
+
+        SerializedTransaction::pointer txn;
+        Handler handler;
+    };
+
+    typedef std::mutex LockType;
+    typedef std::lock_guard <LockType> ScopedLockType;
+
+    JobQueue& m_jobQueue;
+    IHashRouter& m_router;
+    beast::Journal m_journal;
+    int const m_maxJobs;
+
+    LockType m_mutex;
+    std::vector <Entry> m_pending;
+    int m_jobs;
+
+public:
+    SigVerifierImp (JobQueue& jobQueue, IHashRouter& router,
+            beast::Journal journal)
+        : m_jobQueue (jobQueue)
+        , m_router (router)
+        , m_journal (journal)
+        , m_maxJobs (std::max (1u, std::thread::hardware_concurrency ()))
+        , m_jobs (0)
+    {
+    }
+
+    void verify (SerializedTransaction::ref txn, Handler handler) override
+    {
+        ScopedLockType sl (m_mutex);
+
+        m_pending.emplace_back (txn, std::move (handler));
+
+        // Add another job only while each one has a full batch to check
+        if ((m_jobs < m_maxJobs) && ((m_jobs == 0) ||
+            (m_pending.size () > static_cast <std::size_t> (m_jobs) * batchSize)))
+        {
+            ++m_jobs;
+            addJob ();
+        }
+    }
+
+    std::size_t getPendingCount () override
+    {
+        ScopedLockType sl (m_mutex);
+        return m_pending.size ();
+    }
+
+private:
+    void addJob ()
+    {
+        m_jobQueue.addJob (jtTXN_VERIFY, "SigVerifier::verify",
+            std::bind (&SigVerifierImp::doVerify, this,
+                std::placeholders::_1));
+    }
+
+    void doVerify (Job&)
+    {
+        for (int batches = 0; ; ++batches)
+        {
+            std::vector <Entry> batch;
+
+            {
+                ScopedLockType sl (m_mutex);
+
+                if (m_pending.empty ())
+                {
+                    --m_jobs;
+                    return;
+                }
+
+                if (batches == batchesPerJob)
+                {
+                    // Let other work run, the new job keeps our slot
+                    addJob ();
+                    return;
+                }
+
+                if (m_pending.size () <= batchSize)
+                {
+                    batch.swap (m_pending);
+                }
+                else
+                {
+                    auto const first (m_pending.begin ());
+                    batch.assign (std::make_move_iterator (first),
+                        std::make_move_iterator (first + batchSize));
+                    m_pending.erase (first, first + batchSize);
+                }
+            }
+
+            for (auto& entry : batch)
+                check (entry);
+        }
+    }
+
+    void check (Entry& entry)
+    {
+        uint256 const txID (entry.txn->getTransactionID ());
+        bool good;
+
+        // Another path may have checked it while it waited. SF_BAD is
+        // also set for reasons other than the signature, so only the
+        // results of signature checks are trusted here.
+        int const flags (m_router.getFlags (txID));
+
+        if (flags & SF_SIGGOOD)
+            good = true;
+        else if (flags & SF_SIGBAD)
+            good = false;
+        else
+        {
+            good = entry.txn->checkSign ();
+
+            if (good)
+            {
+                m_router.setFlag (txID, SF_SIGGOOD);
+            }
+            else
+            {
+                m_router.setFlag (txID, SF_SIGBAD);
+                m_router.setFlag (txID, SF_BAD);
+            }
+        }
+
+        if (! good)
+            m_journal.debug << "Bad signature on " << txID;
+
+        entry.handler (entry.txn, good);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr <SigVerifier> make_SigVerifier (JobQueue& jobQueue,
+    IHashRouter& router, beast::Journal journal)
+{
+    return std::make_unique <SigVerifierImp> (jobQueue, router, journal);
+}
+
+} // ripple
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SIGVERIFIER_H_INCLUDED
+#define RIPPLE_SIGVERIFIER_H_INCLUDED
+
+namespace ripple {
+
+/** Checks the signatures of incoming transactions in batches.
+
+    Transactions waiting for a signature check are queued here, and jobs on
+    the JobQueue take them in batches. Several jobs may run at once, so the
+    checks spread across the worker threads. Each job's overhead is shared
+    by its whole batch.
+
+    The result is recorded in the HashRouter as SF_SIGGOOD, or as SF_SIGBAD
+    and SF_BAD, and then the transaction's handler is called on the
+    verifying thread.
+*/
+class SigVerifier
+{
+public:
+    /** Called with the result of a signature check. */
+    typedef std::function <void (SerializedTransaction::ref, bool good)> Handler;
+
+    virtual ~SigVerifier () = default;
+
+    /** Queue a transaction to have its signature checked. */
+    virtual void verify (SerializedTransaction::ref txn, Handler handler) = 0;
+
+    /** Return the number of transactions waiting to be checked. */
+    virtual std::size_t getPendingCount () = 0;
+};
+
+std::unique_ptr <SigVerifier> make_SigVerifier (JobQueue& jobQueue,
+    IHashRouter& router, beast::Journal journal);
+
+} // ripple
+
+#endif
@@ -138,7 +138,7 @@ void Transaction::setStatus (TransStatus ts, std::uint32_t lseq)
 
 Transaction::pointer Transaction::transactionFromSQL (Database* db, bool bValidate)
 {
-    Serializer rawTxn;
+    Blob rawTxn;
     std::string status;
     std::uint32_t inLedger;
 
@@ -147,23 +147,30 @@ Transaction::pointer Transaction::transactionFromSQL (Database* db, bool bValida
 
     db->getStr ("Status", status);
     inLedger = db->getInt ("LedgerSeq");
-    txSize = db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.getLength ());
+    txSize = db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
 
-    if (txSize > rawTxn.getLength ())
+    if (txSize > rawTxn.size ())
     {
         rawTxn.resize (txSize);
-        db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.getLength ());
+        db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
     }
 
     rawTxn.resize (txSize);
 
-    SerializerIterator it (rawTxn);
+    return transactionFromSQL (rawTxn, status, inLedger, bValidate);
+}
+
+Transaction::pointer Transaction::transactionFromSQL (Blob const& rawTxn,
+    std::string const& status, std::uint32_t inLedger, bool bValidate)
+{
+    Serializer s (rawTxn);
+    SerializerIterator it (s);
     SerializedTransaction::pointer txn = std::make_shared<SerializedTransaction> (boost::ref (it));
     Transaction::pointer tr = std::make_shared<Transaction> (txn, bValidate);
 
     TransStatus st (INVALID);
 
-    switch (status[0])
+    switch (status.empty () ? TXN_SQL_UNKNOWN : status[0])
     {
     case TXN_SQL_NEW:
         st = NEW;
@@ -208,8 +215,7 @@ Transaction::pointer Transaction::transactionFromSQL (const std::string& sql)
     rawTxn.resize (txSize);
 
     {
-        DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
-        Database* db = getApp().getTxnDB ()->getDB ();
+        DatabaseCon::ReadHandle db (getApp().getTxnDB ()->getReadDB ());
 
         if (!db->executeSQL (sql, true) || !db->startIterRows ())
             return Transaction::pointer ();
@@ -203,7 +203,7 @@ void TransactionAcquire::trigger (Peer::ptr const& peer)
 }
 
 SHAMapAddNode TransactionAcquire::takeNodes (const std::list<SHAMapNode>& nodeIDs,
-        const std::list< Blob >& data, Peer::ptr const& peer)
+        const std::list<const_byte_view>& data, Peer::ptr const& peer)
 {
     if (mComplete)
     {
@@ -223,7 +223,7 @@ SHAMapAddNode TransactionAcquire::takeNodes (const std::list<SHAMapNode>& nodeID
             return SHAMapAddNode::invalid ();
 
         std::list<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
-        std::list< Blob >::const_iterator nodeDatait = data.begin ();
+        std::list<const_byte_view>::const_iterator nodeDatait = data.begin ();
         ConsensusTransSetSF sf (getApp().getTempNodeCache ());
 
         while (nodeIDit != nodeIDs.end ())
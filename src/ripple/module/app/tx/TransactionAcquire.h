@@ -44,7 +44,7 @@ public:
     }
 
     SHAMapAddNode takeNodes (const std::list<SHAMapNode>& IDs,
-                             const std::list< Blob >& data, Peer::ptr const&);
+                             const std::list<const_byte_view>& data, Peer::ptr const&);
 
 private:
     SHAMap::pointer     mMap;
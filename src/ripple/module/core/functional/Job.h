@@ -44,6 +44,8 @@ enum JobType
     jtCLIENT,        // A websocket command from the client
     jtRPC,           // A websocket command from the client
     jtUPDATE_PF,     // Update pathfinding requests
+    jtUPDATE_PF_HELPER, // Help update pathfinding requests in parallel
+    jtTXN_VERIFY,    // Check the signatures of received transactions
     jtTRANSACTION,   // A transaction received from the network
     jtUNL,           // A Score or Fetch of the UNL (DEPRECATED)
     jtADVANCE,       // Advance validated/acquired ledgers
@@ -52,6 +54,7 @@ enum JobType
     jtWAL,           // Write-ahead logging
     jtVALIDATION_t,  // A validation from a trusted source
     jtWRITE,         // Write out hashed objects
+    jtFLUSH_HELPER,  // Help write a ledger's modified nodes
     jtACCEPT,        // Accept a consensus ledger
     jtPROPOSAL_t,    // A proposal from a trusted source
     jtSWEEP,         // Sweep for stale structures
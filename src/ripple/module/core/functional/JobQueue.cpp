@@ -27,7 +27,9 @@
 #include <beast/module/core/thread/Workers.h>
 #include <beast/module/core/system/SystemStats.h>
 
+#include <atomic>
 #include <chrono>
+#include <thread>
 
 namespace ripple {
 
@@ -36,19 +38,24 @@ class JobQueueImp
     , private beast::Workers::Callback
 {
 public:
-    typedef std::set <Job> JobSet;
     typedef std::map <JobType, JobTypeData> JobDataMap;
-    typedef beast::CriticalSection::ScopedLockType ScopedLock;
 
     beast::Journal m_journal;
-    beast::CriticalSection m_mutex;
-    std::uint64_t m_lastJob;
-    JobSet m_jobSet;
+    std::atomic <std::uint64_t> m_lastJob;
+
+    // Never modified after construction, so it may be read without a lock.
+    // Each JobTypeData holds its own queue and counters.
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
+    // The job types in the order they are considered, highest priority first
+    std::vector <JobTypeData*> m_priorityOrder;
+
+    // The number of jobs waiting in all queues
+    std::atomic <int> m_jobCount;
+
     // The number of jobs currently in processTask()
-    int m_processCount;
+    std::atomic <int> m_processCount;
 
     beast::Workers m_workers;
     CancelCallback m_cancelCallback;
@@ -73,6 +80,7 @@ public:
         , m_journal (journal)
         , m_lastJob (0)
         , m_invalidJobData (getJobTypes ().getInvalid (), collector)
+        , m_jobCount (0)
         , m_processCount (0)
         , m_workers (*this, "JobQueue", 0)
         , m_cancelCallback (boost::bind (&Stoppable::isStopping, this))
@@ -82,20 +90,20 @@ public:
             &JobQueueImp::collect, this));
         job_count = m_collector->make_gauge ("job_count");
 
+        for (auto const& x : getJobTypes ())
         {
-            ScopedLock lock (m_mutex);
+            JobTypeInfo const& jt = x.second;
 
-            for (auto const& x : getJobTypes ())
-            {
-                JobTypeInfo const& jt = x.second;
-
-                // And create dynamic information for all jobs
-                auto const result (m_jobData.emplace (std::piecewise_construct,
-                    std::forward_as_tuple (jt.type ()),
-                    std::forward_as_tuple (jt, m_collector)));
-                assert (result.second == true);
-            }
+            // And create dynamic information for all jobs
+            auto const result (m_jobData.emplace (std::piecewise_construct,
+                std::forward_as_tuple (jt.type ()),
+                std::forward_as_tuple (jt, m_collector)));
+            assert (result.second == true);
         }
+
+        // Later job types have higher priority
+        for (auto iter (m_jobData.rbegin ()); iter != m_jobData.rend (); ++iter)
+            m_priorityOrder.push_back (&iter->second);
     }
 
     ~JobQueueImp ()
@@ -106,8 +114,7 @@ public:
 
     void collect ()
     {
-        ScopedLock lock (m_mutex);
-        job_count = m_jobSet.size ();
+        job_count = m_jobCount.load ();
     }
 
     void addJob (JobType type, std::string const& name,
@@ -139,10 +146,9 @@ public:
             //          OR
             //      * Not all children are stopped
             //  
-            ScopedLock lock (m_mutex);
             assert (! isStopped() && (
                 m_processCount>0 ||
-                ! m_jobSet.empty () ||
+                m_jobCount>0 ||
                 ! areChildrenStopped()));
         }
 
@@ -156,31 +162,21 @@ public:
             return;
         }
 
-        {
-            ScopedLock lock (m_mutex);
-
-            std::pair <std::set <Job>::iterator, bool> result (
-                m_jobSet.insert (Job (type, name, ++m_lastJob,
-                    data.load (), jobFunc, m_cancelCallback)));
-            queueJob (*result.first, lock);
-        }
+        queueJob (Job (type, name, ++m_lastJob,
+            data.load (), jobFunc, m_cancelCallback), data);
     }
 
     int getJobCount (JobType t)
     {
-        ScopedLock lock (m_mutex);
-
         JobDataMap::const_iterator c = m_jobData.find (t);
 
         return (c == m_jobData.end ()) 
             ? 0 
-            : c->second.waiting;
+            : c->second.waiting.load ();
     }
 
     int getJobCountTotal (JobType t)
     {
-        ScopedLock lock (m_mutex);
-
         JobDataMap::const_iterator c = m_jobData.find (t);
 
         return (c == m_jobData.end ())
@@ -193,8 +189,6 @@ public:
         // return the number of jobs at this priority level or greater
         int ret = 0;
 
-        ScopedLock lock (m_mutex);
-
         for (auto const& x : m_jobData)
         {
             if (x.first >= t)
@@ -296,8 +290,6 @@ public:
 
         Json::Value priorities = Json::arrayValue;
 
-        ScopedLock lock (m_mutex);
-
         for (auto& x : m_jobData)
         {
             assert (x.first != jtINVALID);
@@ -363,19 +355,19 @@ private:
 
     // Signals the service stopped if the stopped condition is met.
     //
-    void checkStopped (ScopedLock const& lock)
+    void checkStopped ()
     {
         // We are stopped when all of the following are true:
         //
         //  1. A stop notification was received
         //  2. All Stoppable children have stopped
         //  3. There are no executing calls to processTask
-        //  4. There are no remaining Jobs in the job set
+        //  4. There are no remaining Jobs in any queue
         //
         if (isStopping() &&
             areChildrenStopped() &&
             (m_processCount == 0) &&
-            m_jobSet.empty())
+            (m_jobCount == 0))
         {
             stopped();
         }
@@ -387,35 +379,33 @@ private:
     //
     // Pre-conditions:
     //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
     //  The Job must not have previously been queued.
     //
     // Post-conditions:
+    //  The Job is at the back of the queue for its type.
     //  Count of waiting jobs of that type will be incremented.
     //  If JobQueue exists, and has at least one thread, Job will eventually run.
     //
     // Invariants:
-    //  The calling thread owns the JobLock
-    //  
-    void queueJob (Job const& job, ScopedLock const& lock)
+    //  <none>
+    //
+    void queueJob (Job const& job, JobTypeData& data)
     {
         JobType const type (job.getType ());
         assert (type != jtINVALID);
-        assert (m_jobSet.find (job) != m_jobSet.end ());
 
-        JobTypeData& data (getJobTypeData (type));
+        // The job must be visible in the queue before its task is added,
+        // so that every task finds a job to run.
+        ++m_jobCount;
+        data.push (job);
 
-        if (data.waiting + data.running < getJobLimit (type))
+        if (data.admitted++ < getJobLimit (type))
         {
             m_workers.addTask ();
         }
-        else
-        {
-            // defer the task until we go below the limit
-            //
-            ++data.deferred;
-        }
-        ++data.waiting;
+
+        // Otherwise the task is deferred until we go below the limit,
+        // see finishJob.
     }
 
     //------------------------------------------------------------------------------
@@ -423,52 +413,49 @@ private:
     // Returns the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A waiting Job whose type is running below its limit.
     //
     // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    //  At least one RunnableJob exists, or will shortly once a concurrent
+    //  call to queueJob or finishJob completes.
     //
     // Post-conditions:
-    //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is the oldest Job of the highest priority runnable type.
+    //  job is removed from the queue for its type.
     //  Waiting job count of it's type is decremented
     //  Running job count of it's type is incremented
     //
     // Invariants:
-    //  The calling thread owns the JobLock
+    //  <none>
     //
-    void getNextJob (Job& job, ScopedLock const& lock)
+    void getNextJob (Job& job)
     {
-        assert (! m_jobSet.empty ());
-
-        JobSet::const_iterator iter;
-        for (iter = m_jobSet.begin (); iter != m_jobSet.end (); ++iter)
+        for (;;)
         {
-            JobTypeData& data (getJobTypeData (iter->getType ()));
-
-            assert (data.running <= getJobLimit (data.type ()));
-
-            // Run this job if we're running below the limit.
-            if (data.running < getJobLimit (data.type ()))
+            for (auto data : m_priorityOrder)
             {
-                assert (data.waiting > 0);
-                break;
-            }
-        }
+                if (data->waiting.load () == 0)
+                    continue;
 
-        assert (iter != m_jobSet.end ());
+                // Run a job of this type if we're running below the limit.
+                if (! data->tryAcquire ())
+                    continue;
 
-        JobType const type = iter->getType ();
-        JobTypeData& data (getJobTypeData (type));
-
-        assert (type != jtINVALID);
+                if (data->pop (job))
+                {
+                    --m_jobCount;
+                    return;
+                }
 
-        job = *iter;
-        m_jobSet.erase (iter);
+                // Another thread took the last one
+                data->release ();
+            }
 
-        --data.waiting;
-        ++data.running;
+            // Every task is matched by a runnable job, but a thread which
+            // took a job of a different type may not have finished claiming
+            // it yet. Let it catch up.
+            std::this_thread::yield ();
+        }
     }
 
     //------------------------------------------------------------------------------
@@ -476,7 +463,6 @@ private:
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -486,25 +472,20 @@ private:
     // Invariants:
     //  <none>
     //
-    void finishJob (Job const& job, ScopedLock const& lock)
+    void finishJob (Job const& job)
     {
         JobType const type = job.getType ();
 
-        assert (m_jobSet.find (job) == m_jobSet.end ());
         assert (type != jtINVALID);
 
         JobTypeData& data (getJobTypeData (type));
 
-        // Queue a deferred task if possible
-        if (data.deferred > 0)
-        {
-            assert (data.running + data.waiting >= getJobLimit (type));
+        // Release the slot before signaling, so the new task can claim it
+        data.release ();
 
-            --data.deferred;
+        // Queue a deferred task if possible
+        if (data.admitted-- > getJobLimit (type))
             m_workers.addTask ();
-        }
-
-        --data.running;
     }
 
     //--------------------------------------------------------------------------
@@ -545,11 +526,8 @@ private:
     {
         Job job;
 
-        {
-            ScopedLock lock (m_mutex);
-            getNextJob (job, lock);
-            ++m_processCount;
-        }
+        ++m_processCount;
+        getNextJob (job);
 
         JobTypeData& data (getJobTypeData (job.getType ()));
 
@@ -573,12 +551,9 @@ private:
             m_journal.trace << "Skipping processTask ('" << data.name () << "')";
         }
 
-        {
-            ScopedLock lock (m_mutex);
-            finishJob (job, lock);
-            --m_processCount;
-            checkStopped (lock);
-        }
+        finishJob (job);
+        --m_processCount;
+        checkStopped ();
 
         // Note that when Job::~Job is called, the last reference
         // to the associated LoadEvent object (in the Job) may be destroyed.
@@ -620,7 +595,6 @@ private:
 
         /*
         {
-            ScopedLock lock (m_mutex);
 
             // Remove all jobs whose type is skipOnStop
             typedef ripple::unordered_map <JobType, std::size_t> JobDataMap;
@@ -666,9 +640,7 @@ private:
 
     void onChildrenStopped ()
     {
-        ScopedLock lock (m_mutex);
-
-        checkStopped (lock);
+        checkStopped ();
     }
 };
 
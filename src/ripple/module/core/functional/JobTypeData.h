@@ -22,6 +22,10 @@
 
 #include <ripple/module/core/functional/JobTypeInfo.h>
 
+#include <atomic>
+#include <deque>
+#include <mutex>
+
 namespace ripple
 {
 
@@ -33,18 +37,26 @@ private:
     /* Support for insight */
     beast::insight::Collector::ptr m_collector;
 
+    /* Jobs of this type waiting to run, oldest first. The lock is only
+       held to push or pop, and is never shared with other job types.
+    */
+    std::mutex m_queueMutex;
+    std::deque <Job> m_queue;
+
 public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
     /* The number of jobs waiting */
-    int waiting;
+    std::atomic <int> waiting;
 
     /* The number presently running */
-    int running;
+    std::atomic <int> running;
 
-    /* And the number we deferred executing because of job limits */
-    int deferred;
+    /* The number waiting or running. Jobs admitted beyond the limit are
+       deferred, and get a task when a running job of this type finishes.
+    */
+    std::atomic <int> admitted;
 
     /* Notification callbacks */
     beast::insight::Event dequeue;
@@ -56,7 +68,7 @@ public:
         , info (info_)
         , waiting (0)
         , running (0)
-        , deferred (0)
+        , admitted (0)
     {
         m_load.setTargetLatency (
             info.getAverageLatency (),
@@ -92,6 +104,47 @@ public:
     {
         return m_load.getStats ();
     }
+
+    /* Add a job to the back of the queue */
+    void push (Job const& job)
+    {
+        {
+            std::lock_guard <std::mutex> lock (m_queueMutex);
+            m_queue.push_back (job);
+        }
+        ++waiting;
+    }
+
+    /* Remove the oldest job, returns false if there are none */
+    bool pop (Job& job)
+    {
+        {
+            std::lock_guard <std::mutex> lock (m_queueMutex);
+            if (m_queue.empty ())
+                return false;
+            job = m_queue.front ();
+            m_queue.pop_front ();
+        }
+        --waiting;
+        return true;
+    }
+
+    /* Claim a running slot if we are below the limit */
+    bool tryAcquire ()
+    {
+        int count (running.load ());
+        while (count < info.limit ())
+        {
+            if (running.compare_exchange_weak (count, count + 1))
+                return true;
+        }
+        return false;
+    }
+
+    void release ()
+    {
+        --running;
+    }
 };
 
 }
@@ -67,6 +67,10 @@ public:
         add (jtUPDATE_PF,     "updatePaths",
             maxLimit, true,   false, 0,     0);
 
+        // Help update pathfinding requests in parallel
+        add (jtUPDATE_PF_HELPER, "updatePathsHelper",
+            4,        true,   false, 0,     0);
+
         // A websocket command from the client
         add (jtCLIENT,        "clientCommand",
             maxLimit, true,   false, 2000,  5000);
@@ -75,6 +79,10 @@ public:
         add (jtRPC,           "RPC",
             maxLimit, false,  false, 0,     0);
 
+        // Check the signatures of received transactions
+        add (jtTXN_VERIFY,    "verifyTransaction",
+            maxLimit, true,   false, 250,   1000);
+
         // A transaction received from the network
         add (jtTRANSACTION,   "transaction",
             maxLimit, true,   false, 250,   1000);
@@ -107,6 +115,10 @@ public:
         add (jtWRITE,         "writeObjects",
             maxLimit, false,  false, 1750,  2500);
 
+        // Help write a ledger's modified nodes
+        add (jtFLUSH_HELPER,  "flushHelper",
+            3,        true,   false, 0,     0);
+
         // Accept a consensus ledger
         add (jtACCEPT,        "acceptLedger",
             maxLimit, false,  false, 0,     0);
@@ -29,12 +29,15 @@
 
 #include <ripple/common/seconds_clock.h>
 #include <ripple/common/TaggedCache.h>
+#include <ripple/common/ShardedTaggedCache.h>
 #include <ripple/common/KeyCache.h>
 
 #include <ripple/module/core/nodestore/impl/Tuning.h>
 #include <ripple/module/core/nodestore/impl/DecodedBlob.h>
 #include <ripple/module/core/nodestore/impl/EncodedBlob.h>
 #include <ripple/module/core/nodestore/impl/BatchWriter.h>
+#include <ripple/module/core/nodestore/backend/AppendDBFactory.h>
+#include <ripple/module/core/nodestore/backend/AppendDBFactory.cpp>
 #include <ripple/module/core/nodestore/backend/HyperDBFactory.h>
 #include <ripple/module/core/nodestore/backend/HyperDBFactory.cpp>
 #include <ripple/module/core/nodestore/backend/LevelDBFactory.h>
@@ -58,6 +58,19 @@ public:
     */
     virtual Status fetch (void const* key, NodeObject::Ptr* pObject) = 0;
 
+    /** Fetch a group of objects.
+        The default implementation calls @ref fetch for each key. Backends
+        which can amortize the cost of a lookup across many keys should
+        override this.
+        @note This will be called concurrently.
+        @param keys Pointers to the key data, in any order.
+        @param results [out] The created objects, in the same order as
+                       the keys. Objects which were not fetched are null.
+        @return The result of each fetch, in the same order as the keys.
+    */
+    virtual std::vector <Status> fetchBatch (
+        std::vector <void const*> const& keys, Batch& results);
+
     /** Store a single object.
         Depending on the implementation this may happen immediately
         or deferred using a scheduled task.
@@ -62,6 +62,20 @@ public:
     */
     virtual NodeObject::pointer fetch (uint256 const& hash) = 0;
 
+    /** Fetch a group of objects.
+        This behaves as if @ref fetch were called for each hash, but
+        objects which are not in the cache are retrieved from the backend
+        using as few requests as possible. Any of the hashes which are
+        queued for an asynchronous read are claimed by this call.
+
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @return The objects, in the same order as the hashes. An object
+                which couldn't be retrieved is `nullptr`.
+    */
+    virtual std::vector <NodeObject::Ptr> fetchBatch (
+        std::vector <uint256> const& hashes) = 0;
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
@@ -114,7 +128,7 @@ public:
     virtual void import (Database& source) = 0;
 
     /** Retrieve the estimated number of pending write operations.
-        This is used for diagnostics.
+        This is used for diagnostics and to detect a write backlog.
     */
     virtual int getWriteLoad () = 0;
 
@@ -27,6 +27,7 @@ namespace NodeStore {
 struct FetchReport
 {
     std::chrono::milliseconds elapsed;
+    int fetchCount;
     bool isAsync;
     bool wentToDisk;
     bool wasFound;
@@ -36,7 +37,9 @@ struct FetchReport
 struct BatchWriteReport
 {
     std::chrono::milliseconds elapsed;
+    std::chrono::milliseconds queued;
     int writeCount;
+    int pending;
 };
 
 /** Scheduling for asynchronous backend activity
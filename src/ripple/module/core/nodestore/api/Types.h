@@ -29,6 +29,15 @@ enum
     // batch objects and does not affect the amount written.
     //
     batchWritePreallocationSize = 128
+
+    // Most objects a single batch write hands to the backend
+    ,batchWriteSize = 8192
+
+    // Pending objects beyond which storing threads help write
+    ,batchWriteLimit = 65536
+
+    // Most batches a thread-safe backend writes at once
+    ,batchWriteMaxWriters = 4
 };
 
 /** Return codes from Backend operations. */
@@ -0,0 +1,968 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#if RIPPLE_APPENDDB_AVAILABLE
+
+#include <boost/filesystem.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <ripple/common/UnorderedContainers.h>
+
+#include <cerrno>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Memory-mapped open-addressing hash table of record locations.
+
+    The file holds a header followed by a power of two number of slots.
+    A key is placed using its first eight bytes, which are uniformly
+    distributed since keys are hashes, and collisions are resolved with
+    linear probing. The first sixteen bytes of the key are kept in the
+    slot so that a lookup never reads the data file for the wrong key.
+
+    The table is kept at most half full so probe sequences stay short.
+
+    The header fills a whole number of slots, so no slot straddles a page
+    and a crash can't leave a slot half written to disk.
+
+    @note The file uses the byte order of the host.
+*/
+class AppendDBIndex
+{
+public:
+    struct Header
+    {
+        char magic [8];
+        std::uint64_t keyBytes;
+        std::uint64_t capacity;
+        std::uint64_t count;
+        // Number of bytes of the data file described by the index
+        std::uint64_t dataSize;
+        // Nonzero if the index was closed after all writes were flushed
+        std::uint64_t clean;
+        // Number of bytes of the data file whose records were all in the
+        // index when it was last synced
+        std::uint64_t checkpoint;
+        std::uint64_t unused;
+    };
+
+    struct Slot
+    {
+        // Offset of the record in the data file plus one, or zero if empty
+        std::uint64_t offset;
+        std::uint64_t hash;
+        std::uint64_t tag;
+        std::uint64_t size;
+    };
+
+    /** Create a new, empty index, replacing any existing file. */
+    AppendDBIndex (std::string const& path, std::size_t keyBytes,
+        std::uint64_t capacity)
+        : m_fd (-1)
+        , m_map (nullptr)
+        , m_mapBytes (sizeof (Header) + capacity * sizeof (Slot))
+    {
+        assert ((capacity & (capacity - 1)) == 0);
+
+        m_fd = ::open (path.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd == -1)
+            throw std::runtime_error ("Unable to create AppendDB index " + path);
+
+        if (::ftruncate (m_fd, m_mapBytes) != 0)
+        {
+            ::close (m_fd);
+            throw std::runtime_error ("Unable to size AppendDB index " + path);
+        }
+
+        map (path);
+
+        memcpy (header ().magic, s_magic, sizeof (header ().magic));
+        header ().keyBytes = keyBytes;
+        header ().capacity = capacity;
+        header ().count = 0;
+        header ().dataSize = 0;
+        header ().clean = 0;
+        header ().checkpoint = 0;
+        header ().unused = 0;
+    }
+
+    /** Open an existing index.
+        @see isUsable
+    */
+    explicit AppendDBIndex (std::string const& path)
+        : m_fd (-1)
+        , m_map (nullptr)
+        , m_mapBytes (0)
+    {
+        m_fd = ::open (path.c_str (), O_RDWR);
+        if (m_fd == -1)
+            return;
+
+        struct stat st;
+        if ((::fstat (m_fd, &st) != 0) || (static_cast <std::uint64_t> (st.st_size) < sizeof (Header)))
+            return;
+
+        m_mapBytes = st.st_size;
+        map (path);
+    }
+
+    ~AppendDBIndex ()
+    {
+        if (m_map != nullptr)
+            ::munmap (m_map, m_mapBytes);
+
+        if (m_fd != -1)
+            ::close (m_fd);
+    }
+
+    AppendDBIndex (AppendDBIndex const&) = delete;
+    AppendDBIndex& operator= (AppendDBIndex const&) = delete;
+
+    /** Returns `true` if the file is a well formed index for these keys. */
+    bool isValid (std::size_t keyBytes) const
+    {
+        if (m_map == nullptr)
+            return false;
+
+        Header const& h (header ());
+
+        return (memcmp (h.magic, s_magic, sizeof (h.magic)) == 0) &&
+            (h.keyBytes == keyBytes) &&
+            (h.capacity != 0) &&
+            ((h.capacity & (h.capacity - 1)) == 0) &&
+            (m_mapBytes == sizeof (Header) + h.capacity * sizeof (Slot));
+    }
+
+    /** Returns `true` if the index may be trusted for the given data file. */
+    bool isUsable (std::size_t keyBytes, std::uint64_t dataSize) const
+    {
+        return isValid (keyBytes) &&
+            (header ().clean != 0) &&
+            (header ().dataSize == dataSize);
+    }
+
+    std::uint64_t getCapacity () const
+    {
+        return header ().capacity;
+    }
+
+    std::uint64_t getCount () const
+    {
+        return header ().count;
+    }
+
+    std::uint64_t getCheckpoint () const
+    {
+        return header ().checkpoint;
+    }
+
+    /** Recompute the count from the slots.
+        After a crash the count on disk may not match the slots.
+    */
+    void recount ()
+    {
+        std::uint64_t count (0);
+
+        for (std::uint64_t i = 0; i < header ().capacity; ++i)
+        {
+            if (slots () [i].offset != 0)
+                ++count;
+        }
+
+        header ().count = count;
+    }
+
+    /** Returns `true` if adding this many entries would overfill the table. */
+    bool needsGrowth (std::uint64_t additional) const
+    {
+        return (header ().count + additional) * 2 > header ().capacity;
+    }
+
+    /** Locate the record for a key.
+        @return `true` if the key is present.
+    */
+    bool find (void const* key, std::uint64_t& offset, std::uint64_t& size) const
+    {
+        Slot probe;
+        makeSlot (key, probe);
+
+        std::uint64_t const mask (header ().capacity - 1);
+
+        for (std::uint64_t i = probe.hash & mask;; i = (i + 1) & mask)
+        {
+            Slot const& slot (slots () [i]);
+
+            if (slot.offset == 0)
+                return false;
+
+            if ((slot.hash == probe.hash) && (slot.tag == probe.tag))
+            {
+                offset = slot.offset - 1;
+                size = slot.size;
+                return true;
+            }
+        }
+    }
+
+    /** Add the location of a record.
+        @return `false` if the key was already present.
+    */
+    bool insert (void const* key, std::uint64_t offset, std::uint64_t size)
+    {
+        Slot slot;
+        makeSlot (key, slot);
+        slot.offset = offset + 1;
+        slot.size = size;
+        return insert (slot);
+    }
+
+    /** Add every entry in this index to another index. */
+    void copyTo (AppendDBIndex& dest) const
+    {
+        for (std::uint64_t i = 0; i < header ().capacity; ++i)
+        {
+            if (slots () [i].offset != 0)
+                dest.insert (slots () [i]);
+        }
+    }
+
+    void setDataSize (std::uint64_t dataSize)
+    {
+        header ().dataSize = dataSize;
+    }
+
+    void setClean (bool clean)
+    {
+        header ().clean = clean ? 1 : 0;
+    }
+
+    /** Record that every record before this offset is in the index.
+        The slots must have been synced first.
+    */
+    void setCheckpoint (std::uint64_t checkpoint)
+    {
+        header ().checkpoint = checkpoint;
+    }
+
+    /** Flush the mapped pages to the file. */
+    void sync ()
+    {
+        ::msync (m_map, m_mapBytes, MS_SYNC);
+    }
+
+private:
+    void map (std::string const& path)
+    {
+        void* const p = ::mmap (nullptr, m_mapBytes,
+            PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+        if (p == MAP_FAILED)
+        {
+            ::close (m_fd);
+            m_fd = -1;
+            throw std::runtime_error ("Unable to map AppendDB index " + path);
+        }
+
+        m_map = p;
+    }
+
+    static void makeSlot (void const* key, Slot& slot)
+    {
+        unsigned char const* const k (static_cast <unsigned char const*> (key));
+        memcpy (&slot.hash, k, sizeof (slot.hash));
+        memcpy (&slot.tag, k + sizeof (slot.hash), sizeof (slot.tag));
+    }
+
+    bool insert (Slot const& entry)
+    {
+        std::uint64_t const mask (header ().capacity - 1);
+
+        for (std::uint64_t i = entry.hash & mask;; i = (i + 1) & mask)
+        {
+            Slot& slot (slots () [i]);
+
+            if (slot.offset == 0)
+            {
+                slot = entry;
+                ++header ().count;
+                return true;
+            }
+
+            if ((slot.hash == entry.hash) && (slot.tag == entry.tag))
+                return false;
+        }
+    }
+
+    Header& header () const
+    {
+        return *static_cast <Header*> (m_map);
+    }
+
+    Slot* slots () const
+    {
+        return reinterpret_cast <Slot*> (
+            static_cast <char*> (m_map) + sizeof (Header));
+    }
+
+    static char const s_magic [8];
+
+    int m_fd;
+    void* m_map;
+    std::size_t m_mapBytes;
+};
+
+char const AppendDBIndex::s_magic [8] = { 'R', 'I', 'P', 'A', 'P', 'P', 'X', '2' };
+
+//------------------------------------------------------------------------------
+
+/** An append-only data file together with its index.
+
+    Each record in the data file is the key, followed by the 32-bit
+    big-endian size of the value, followed by the value as produced by
+    EncodedBlob.
+
+    Appended records are synced to disk before they are added to the
+    index, so the index never points at data that could be lost in a
+    crash. Every checkpointBytes of appends, the index is synced and
+    records how much of the data file it covers.
+
+    The index is trusted as is only if it was closed cleanly and describes
+    the whole data file. After a crash, the data file is scanned from the
+    last checkpoint and the records found are added to the index. A
+    partial record at the end, left by the crash, is discarded. If the
+    index is missing or damaged, it is rebuilt from the whole data file.
+
+    Any number of threads may read, but only one may append at a time.
+*/
+class AppendDBStore
+{
+public:
+    enum
+    {
+        // Number of slots in a newly created index
+        initialCapacity = 65536
+
+        // Size of the buffer used when scanning the data file
+        ,scanBufferBytes = 4 * 1024 * 1024
+
+        // Records claiming a larger value than this are treated as corrupt
+        ,maxValueBytes = 64 * 1024 * 1024
+
+        // Bytes appended between index checkpoints
+        ,checkpointBytes = 64 * 1024 * 1024
+    };
+
+    AppendDBStore (std::size_t keyBytes, std::string const& path,
+        beast::Journal journal)
+        : m_journal (journal)
+        , m_keyBytes (keyBytes)
+        , m_dataPath ((boost::filesystem::path (path) / "data.dat").string ())
+        , m_indexPath ((boost::filesystem::path (path) / "index.dat").string ())
+        , m_fd (-1)
+        , m_dataSize (0)
+    {
+        if (m_keyBytes < 2 * sizeof (std::uint64_t))
+            throw std::runtime_error ("AppendDB requires keys of at least 16 bytes");
+
+        boost::filesystem::create_directories (path);
+
+        m_fd = ::open (m_dataPath.c_str (), O_RDWR | O_CREAT, 0644);
+        if (m_fd == -1)
+            throw std::runtime_error ("Unable to open/create AppendDB data " + m_dataPath);
+
+        struct stat st;
+        if (::fstat (m_fd, &st) != 0)
+        {
+            ::close (m_fd);
+            throw std::runtime_error ("Unable to stat AppendDB data " + m_dataPath);
+        }
+
+        m_dataSize = st.st_size;
+
+        m_index.reset (new AppendDBIndex (m_indexPath));
+
+        if (! m_index->isUsable (m_keyBytes, m_dataSize))
+        {
+            if (m_index->isValid (m_keyBytes) &&
+                    (m_index->getCheckpoint () <= m_dataSize))
+                recover ();
+            else
+                rebuild ();
+        }
+
+        // Until we close cleanly the index can't be trusted
+        m_index->setClean (false);
+        m_index->sync ();
+    }
+
+    ~AppendDBStore ()
+    {
+        ::fdatasync (m_fd);
+
+        m_index->setDataSize (m_dataSize);
+        m_index->sync ();
+        m_index->setCheckpoint (m_dataSize);
+        m_index->setClean (true);
+        m_index->sync ();
+        m_index.reset ();
+
+        ::close (m_fd);
+    }
+
+    AppendDBStore (AppendDBStore const&) = delete;
+    AppendDBStore& operator= (AppendDBStore const&) = delete;
+
+    /** Read the value for a key with a single read of the data file. */
+    Status fetch (void const* key, NodeObject::Ptr* pObject)
+    {
+        pObject->reset ();
+
+        std::uint64_t offset;
+        std::uint64_t size;
+
+        {
+            boost::shared_lock <boost::shared_mutex> lock (m_mutex);
+
+            if (! m_index->find (key, offset, size))
+                return notFound;
+        }
+
+        std::vector <unsigned char> record (size);
+
+        if (! read (offset, record.data (), size))
+            return unknown;
+
+        // The index only holds part of the key
+        if (memcmp (record.data (), key, m_keyBytes) != 0)
+            return dataCorrupt;
+
+        DecodedBlob decoded (key, record.data () + headerBytes (),
+            size - headerBytes ());
+
+        if (! decoded.wasOk ())
+            return dataCorrupt;
+
+        *pObject = decoded.createObject ();
+
+        return ok;
+    }
+
+    /** Append the objects which are not already present. */
+    void append (Batch const& batch)
+    {
+        // Appends from the batch writer and from import can overlap
+        std::lock_guard <std::mutex> appendLock (m_appendMutex);
+
+        std::vector <unsigned char> buffer;
+
+        // Offset of each record within the buffer
+        std::vector <std::size_t> records;
+        records.reserve (batch.size ());
+
+        // Keys already in the buffer, so a duplicate is written once
+        unordered_set <uint256> keys;
+
+        EncodedBlob encoded;
+
+        for (auto const& e : batch)
+        {
+            std::uint64_t offset;
+            std::uint64_t size;
+
+            // Holding the append mutex keeps the index from
+            // changing, so reading it here doesn't need the lock.
+            if (m_index->find (e->getHash ().begin (), offset, size))
+                continue;
+
+            if (! keys.insert (e->getHash ()).second)
+                continue;
+
+            encoded.prepare (e);
+
+            std::uint32_t const valueBytes (
+                beast::ByteOrder::swapIfLittleEndian (
+                    static_cast <std::uint32_t> (encoded.getSize ())));
+
+            unsigned char const* const key (
+                static_cast <unsigned char const*> (encoded.getKey ()));
+            unsigned char const* const value (
+                static_cast <unsigned char const*> (encoded.getData ()));
+            unsigned char const* const size_ (
+                reinterpret_cast <unsigned char const*> (&valueBytes));
+
+            records.push_back (buffer.size ());
+
+            buffer.insert (buffer.end (), key, key + m_keyBytes);
+            buffer.insert (buffer.end (), size_, size_ + sizeof (valueBytes));
+            buffer.insert (buffer.end (), value, value + encoded.getSize ());
+        }
+
+        if (records.empty ())
+            return;
+
+        if (! write (m_dataSize, buffer.data (), buffer.size ()))
+        {
+            if (m_journal.fatal) m_journal.fatal <<
+                "Unable to append " << buffer.size () << " bytes to " << m_dataPath;
+            return;
+        }
+
+        // The records must be on disk before the index points at them
+        if (::fdatasync (m_fd) != 0)
+        {
+            if (m_journal.fatal) m_journal.fatal <<
+                "Unable to sync " << buffer.size () << " bytes to " << m_dataPath;
+            return;
+        }
+
+        {
+            boost::unique_lock <boost::shared_mutex> lock (m_mutex);
+
+            if (m_index->needsGrowth (records.size ()))
+                grow (records.size ());
+
+            for (std::size_t i = 0; i < records.size (); ++i)
+            {
+                std::size_t const begin (records [i]);
+                std::size_t const end ((i + 1 < records.size ())
+                    ? records [i + 1] : buffer.size ());
+
+                m_index->insert (buffer.data () + begin,
+                    m_dataSize + begin, end - begin);
+            }
+
+            m_dataSize += buffer.size ();
+            m_index->setDataSize (m_dataSize);
+        }
+
+        // Holding the append mutex keeps the index from being replaced
+        if (m_dataSize - m_index->getCheckpoint () >= checkpointBytes)
+            checkpoint ();
+    }
+
+    /** Call a function with every object in the data file. */
+    void for_each (std::function <void(NodeObject::Ptr)> f)
+    {
+        scan ([&](std::uint64_t, unsigned char const* record, std::size_t size)
+        {
+            DecodedBlob decoded (record, record + headerBytes (),
+                size - headerBytes ());
+
+            if (decoded.wasOk ())
+            {
+                f (decoded.createObject ());
+            }
+            else
+            {
+                // Uh oh, corrupted data!
+                if (m_journal.fatal) m_journal.fatal <<
+                    "Corrupt NodeObject #" << uint256::fromVoid (record);
+            }
+        });
+    }
+
+private:
+    std::size_t headerBytes () const
+    {
+        return m_keyBytes + sizeof (std::uint32_t);
+    }
+
+    bool read (std::uint64_t offset, void* buffer, std::size_t size)
+    {
+        char* p (static_cast <char*> (buffer));
+
+        while (size > 0)
+        {
+            ssize_t const n = ::pread (m_fd, p, size, offset);
+
+            if (n <= 0)
+            {
+                if ((n == -1) && (errno == EINTR))
+                    continue;
+                return false;
+            }
+
+            p += n;
+            offset += n;
+            size -= n;
+        }
+
+        return true;
+    }
+
+    bool write (std::uint64_t offset, void const* buffer, std::size_t size)
+    {
+        char const* p (static_cast <char const*> (buffer));
+
+        while (size > 0)
+        {
+            ssize_t const n = ::pwrite (m_fd, p, size, offset);
+
+            if (n <= 0)
+            {
+                if ((n == -1) && (errno == EINTR))
+                    continue;
+                return false;
+            }
+
+            p += n;
+            offset += n;
+            size -= n;
+        }
+
+        return true;
+    }
+
+    /** Visit each complete record in the data file, from an offset.
+        @return The offset just past the last complete record.
+    */
+    std::uint64_t scan (
+        std::function <void (std::uint64_t, unsigned char const*, std::size_t)> f,
+        std::uint64_t start = 0)
+    {
+        std::vector <unsigned char> buffer (scanBufferBytes);
+        std::uint64_t bufferOffset (start); // file offset of buffer [0]
+        std::size_t have (0);               // valid bytes in the buffer
+        std::size_t pos (0);                // start of the next record
+        std::uint64_t end (start);
+
+        // Make sure `need` bytes starting at `pos` are in the buffer
+        auto fill = [&](std::size_t need) -> bool
+        {
+            while (have - pos < need)
+            {
+                if (pos > 0)
+                {
+                    memmove (buffer.data (), buffer.data () + pos, have - pos);
+                    bufferOffset += pos;
+                    have -= pos;
+                    pos = 0;
+                }
+
+                if (buffer.size () < need)
+                    buffer.resize (need);
+
+                ssize_t const n = ::pread (m_fd, buffer.data () + have,
+                    buffer.size () - have, bufferOffset + have);
+
+                if (n <= 0)
+                {
+                    if ((n == -1) && (errno == EINTR))
+                        continue;
+                    return false;
+                }
+
+                have += n;
+            }
+
+            return true;
+        };
+
+        while (fill (headerBytes ()))
+        {
+            std::uint32_t valueBytes;
+            memcpy (&valueBytes, buffer.data () + pos + m_keyBytes,
+                sizeof (valueBytes));
+            valueBytes = beast::ByteOrder::swapIfLittleEndian (valueBytes);
+
+            if (valueBytes > maxValueBytes)
+            {
+                if (m_journal.fatal) m_journal.fatal <<
+                    "Bad value size " << valueBytes << " at offset " <<
+                        (bufferOffset + pos) << " in " << m_dataPath;
+                break;
+            }
+
+            std::size_t const recordBytes (headerBytes () + valueBytes);
+
+            if (! fill (recordBytes))
+                break;
+
+            f (bufferOffset + pos, buffer.data () + pos, recordBytes);
+
+            pos += recordBytes;
+            end = bufferOffset + pos;
+        }
+
+        return end;
+    }
+
+    /** Recreate the index from the contents of the data file. */
+    void rebuild ()
+    {
+        if (m_journal.warning) m_journal.warning <<
+            "Rebuilding index " << m_indexPath;
+
+        m_index.reset ();
+
+        std::string const tempPath (m_indexPath + ".tmp");
+
+        std::unique_ptr <AppendDBIndex> index (new AppendDBIndex (
+            tempPath, m_keyBytes, initialCapacity));
+
+        std::uint64_t const end = scan ([&](std::uint64_t offset,
+            unsigned char const* record, std::size_t size)
+        {
+            if (index->needsGrowth (1))
+            {
+                std::unique_ptr <AppendDBIndex> bigger (new AppendDBIndex (
+                    tempPath + ".tmp", m_keyBytes, index->getCapacity () * 2));
+                index->copyTo (*bigger);
+                index = std::move (bigger);
+                boost::filesystem::rename (tempPath + ".tmp", tempPath);
+            }
+
+            index->insert (record, offset, size);
+        });
+
+        truncate (end);
+
+        index->setDataSize (m_dataSize);
+        index->setCheckpoint (m_dataSize);
+        index->sync ();
+        boost::filesystem::rename (tempPath, m_indexPath);
+        m_index = std::move (index);
+
+        if (m_journal.info) m_journal.info <<
+            "Indexed " << m_index->getCount () << " objects in " << m_dataPath;
+    }
+
+    /** Bring the index up to date after a crash.
+        Only the data appended since the last checkpoint is scanned.
+    */
+    void recover ()
+    {
+        std::uint64_t const start (m_index->getCheckpoint ());
+
+        if (m_journal.warning) m_journal.warning <<
+            "Recovering index " << m_indexPath << " from offset " << start;
+
+        m_index->recount ();
+
+        std::uint64_t const end = scan ([&](std::uint64_t offset,
+            unsigned char const* record, std::size_t size)
+        {
+            if (m_index->needsGrowth (1))
+                grow (1);
+
+            m_index->insert (record, offset, size);
+        }, start);
+
+        truncate (end);
+
+        m_index->setDataSize (m_dataSize);
+        checkpoint ();
+
+        if (m_journal.info) m_journal.info <<
+            "Indexed " << m_index->getCount () << " objects in " << m_dataPath;
+    }
+
+    /** Discard a partial record at the end of the data file. */
+    void truncate (std::uint64_t end)
+    {
+        if (end == m_dataSize)
+            return;
+
+        if (m_journal.warning) m_journal.warning <<
+            "Discarding " << (m_dataSize - end) <<
+                " bytes of partial data from " << m_dataPath;
+
+        if (::ftruncate (m_fd, end) != 0)
+            throw std::runtime_error ("Unable to truncate AppendDB data " + m_dataPath);
+
+        m_dataSize = end;
+    }
+
+    /** Sync the index, then record that it covers the whole data file.
+        The slots go to disk before the checkpoint that vouches for them.
+    */
+    void checkpoint ()
+    {
+        m_index->sync ();
+        m_index->setCheckpoint (m_dataSize);
+        m_index->sync ();
+    }
+
+    /** Replace the index with a larger one able to hold more entries.
+        The caller must hold the exclusive lock.
+    */
+    void grow (std::uint64_t additional)
+    {
+        std::uint64_t capacity (m_index->getCapacity () * 2);
+        while ((m_index->getCount () + additional) * 2 > capacity)
+            capacity *= 2;
+
+        std::string const tempPath (m_indexPath + ".tmp");
+
+        std::unique_ptr <AppendDBIndex> index (new AppendDBIndex (
+            tempPath, m_keyBytes, capacity));
+
+        m_index->copyTo (*index);
+        index->setDataSize (m_dataSize);
+        index->setCheckpoint (m_index->getCheckpoint ());
+        index->sync ();
+        boost::filesystem::rename (tempPath, m_indexPath);
+        m_index = std::move (index);
+
+        if (m_journal.debug) m_journal.debug <<
+            "Index " << m_indexPath << " grown to " << capacity << " slots";
+    }
+
+private:
+    beast::Journal m_journal;
+    std::size_t const m_keyBytes;
+    std::string const m_dataPath;
+    std::string const m_indexPath;
+    int m_fd;
+    std::uint64_t m_dataSize;
+    std::unique_ptr <AppendDBIndex> m_index;
+
+    // Guards the index against being changed while it is read
+    boost::shared_mutex m_mutex;
+
+    // Serializes appends, which read and advance the data size
+    std::mutex m_appendMutex;
+};
+
+//------------------------------------------------------------------------------
+
+class AppendDBBackend
+    : public Backend
+    , public BatchWriter::Callback
+    , public beast::LeakChecked <AppendDBBackend>
+{
+public:
+    beast::Journal m_journal;
+    size_t const m_keyBytes;
+    Scheduler& m_scheduler;
+    std::string m_name;
+    AppendDBStore m_store;
+    // Declared last so pending writes are flushed before the store closes.
+    BatchWriter m_batch;
+
+    AppendDBBackend (size_t keyBytes, Parameters const& keyValues,
+        Scheduler& scheduler, beast::Journal journal)
+        : m_journal (journal)
+        , m_keyBytes (keyBytes)
+        , m_scheduler (scheduler)
+        , m_name (checkPath (keyValues ["path"].toStdString ()))
+        , m_store (keyBytes, m_name, journal)
+        , m_batch (*this, scheduler)
+    {
+    }
+
+    std::string
+    getName()
+    {
+        return m_name;
+    }
+
+    //--------------------------------------------------------------------------
+
+    Status
+    fetch (void const* key, NodeObject::Ptr* pObject)
+    {
+        return m_store.fetch (key, pObject);
+    }
+
+    void
+    store (NodeObject::ref object)
+    {
+        m_batch.store (object);
+    }
+
+    void
+    storeBatch (Batch const& batch)
+    {
+        m_store.append (batch);
+    }
+
+    void
+    for_each (std::function <void(NodeObject::Ptr)> f)
+    {
+        m_store.for_each (f);
+    }
+
+    int
+    getWriteLoad ()
+    {
+        return m_batch.getWriteLoad ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void
+    writeBatch (Batch const& batch)
+    {
+        storeBatch (batch);
+    }
+
+private:
+    static std::string
+    checkPath (std::string const& path)
+    {
+        if (path.empty())
+            throw std::runtime_error ("Missing path in AppendDBFactory backend");
+        return path;
+    }
+};
+
+//------------------------------------------------------------------------------
+
+class AppendDBFactory : public Factory
+{
+public:
+    beast::String
+    getName () const
+    {
+        return "AppendDB";
+    }
+
+    std::unique_ptr <Backend>
+    createInstance (
+        size_t keyBytes,
+        Parameters const& keyValues,
+        Scheduler& scheduler,
+        beast::Journal journal)
+    {
+        return std::make_unique <AppendDBBackend> (
+            keyBytes, keyValues, scheduler, journal);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr <Factory>
+make_AppendDBFactory ()
+{
+    return std::make_unique <AppendDBFactory> ();
+}
+
+}
+}
+
+#endif
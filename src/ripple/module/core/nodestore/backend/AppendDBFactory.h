@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_APPENDDBFACTORY_H_INCLUDED
+#define RIPPLE_NODESTORE_APPENDDBFACTORY_H_INCLUDED
+
+#if ! BEAST_WIN32
+#define RIPPLE_APPENDDB_AVAILABLE 1
+#else
+#define RIPPLE_APPENDDB_AVAILABLE 0
+#endif
+
+#if RIPPLE_APPENDDB_AVAILABLE
+
+namespace ripple {
+namespace NodeStore {
+
+/** Factory to produce append-only backends for the NodeStore.
+
+    Node objects are immutable and addressed by their hash, so there is
+    never a need to update or delete one in place. This backend appends
+    each object to a data file and records its location in a memory-mapped
+    open-addressing hash table, so a lookup costs one read of the data file
+    and writes are never rewritten by compaction.
+
+    @see Database
+*/
+std::unique_ptr <Factory> make_AppendDBFactory ();
+
+}
+}
+
+#endif
+
+#endif
@@ -38,7 +38,7 @@ public:
         : m_journal (journal)
         , m_keyBytes (keyBytes)
         , m_scheduler (scheduler)
-        , m_batch (*this, scheduler)
+        , m_batch (*this, scheduler, batchWriteMaxWriters)
         , m_name (keyValues ["path"].toStdString ())
     {
         if (m_name.empty())
@@ -142,6 +142,64 @@ public:
         return status;
     }
 
+    std::vector <Status>
+    fetchBatch (std::vector <void const*> const& keys, Batch& results)
+    {
+        std::vector <Status> statuses;
+        statuses.reserve (keys.size ());
+
+        results.clear ();
+        results.resize (keys.size ());
+
+        // Point lookups use the bloom filters, which suits the sparse
+        // random keys of the node store. The snapshot gives the whole
+        // batch one consistent view of the database.
+        leveldb::ReadOptions options;
+        options.snapshot = m_db->GetSnapshot ();
+
+        std::string string;
+
+        for (std::size_t i = 0; i < keys.size (); ++i)
+        {
+            leveldb::Slice const slice (static_cast <char const*> (keys [i]), m_keyBytes);
+
+            leveldb::Status const getStatus = m_db->Get (options, slice, &string);
+
+            if (getStatus.ok ())
+            {
+                DecodedBlob decoded (keys [i], string.data (), string.size ());
+
+                if (decoded.wasOk ())
+                {
+                    results [i] = decoded.createObject ();
+                    statuses.push_back (ok);
+                }
+                else
+                {
+                    // Decoding failed, probably corrupted!
+                    //
+                    statuses.push_back (dataCorrupt);
+                }
+            }
+            else if (getStatus.IsCorruption ())
+            {
+                statuses.push_back (dataCorrupt);
+            }
+            else if (getStatus.IsNotFound ())
+            {
+                statuses.push_back (notFound);
+            }
+            else
+            {
+                statuses.push_back (unknown);
+            }
+        }
+
+        m_db->ReleaseSnapshot (options.snapshot);
+
+        return statuses;
+    }
+
     void
     store (NodeObject::ref object)
     {
@@ -68,6 +68,25 @@ public:
         return ok;
     }
 
+    std::vector <Status>
+    fetchBatch (std::vector <void const*> const& keys, Batch& results)
+    {
+        results.clear ();
+        results.reserve (keys.size ());
+
+        for (auto const key : keys)
+        {
+            Map::iterator iter = m_map.find (uint256::fromVoid (key));
+
+            if (iter != m_map.end ())
+                results.push_back (iter->second);
+            else
+                results.push_back (nullptr);
+        }
+
+        return std::vector <Status> (keys.size (), ok);
+    }
+
     void
     store (NodeObject::ref object)
     {
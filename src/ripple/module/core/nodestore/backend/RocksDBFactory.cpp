@@ -92,7 +92,7 @@ public:
         : m_journal (journal)
         , m_keyBytes (keyBytes)
         , m_scheduler (scheduler)
-        , m_batch (*this, scheduler)
+        , m_batch (*this, scheduler, batchWriteMaxWriters)
         , m_name (keyValues ["path"].toStdString ())
     {
         if (m_name.empty())
@@ -233,6 +233,69 @@ public:
         return status;
     }
 
+    std::vector <Status>
+    fetchBatch (std::vector <void const*> const& keys, Batch& results)
+    {
+        std::vector <Status> statuses;
+        statuses.reserve (keys.size ());
+
+        results.clear ();
+        results.resize (keys.size ());
+
+        std::vector <rocksdb::Slice> slices;
+        slices.reserve (keys.size ());
+
+        for (auto const key : keys)
+            slices.emplace_back (static_cast <char const*> (key), m_keyBytes);
+
+        rocksdb::ReadOptions const options;
+
+        std::vector <std::string> strings;
+
+        std::vector <rocksdb::Status> const getStatuses (
+            m_db->MultiGet (options, slices, &strings));
+
+        for (std::size_t i = 0; i < keys.size (); ++i)
+        {
+            rocksdb::Status const& getStatus (getStatuses [i]);
+
+            if (getStatus.ok ())
+            {
+                DecodedBlob decoded (keys [i],
+                                     strings [i].data (),
+                                     strings [i].size ());
+
+                if (decoded.wasOk ())
+                {
+                    results [i] = decoded.createObject ();
+                    statuses.push_back (ok);
+                }
+                else
+                {
+                    // Decoding failed, probably corrupted!
+                    //
+                    statuses.push_back (dataCorrupt);
+                }
+            }
+            else if (getStatus.IsCorruption ())
+            {
+                statuses.push_back (dataCorrupt);
+            }
+            else if (getStatus.IsNotFound ())
+            {
+                statuses.push_back (notFound);
+            }
+            else
+            {
+                statuses.push_back (Status (customCode + getStatus.code()));
+
+                m_journal.error << getStatus.ToString ();
+            }
+        }
+
+        return statuses;
+    }
+
     void
     store (NodeObject::ref object)
     {
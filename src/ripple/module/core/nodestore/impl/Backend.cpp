@@ -24,5 +24,20 @@ Backend::~Backend ()
 {
 }
 
+std::vector <Status>
+Backend::fetchBatch (std::vector <void const*> const& keys, Batch& results)
+{
+    std::vector <Status> statuses;
+    statuses.reserve (keys.size ());
+
+    results.clear ();
+    results.resize (keys.size ());
+
+    for (std::size_t i = 0; i < keys.size (); ++i)
+        statuses.push_back (fetch (keys [i], &results [i]));
+
+    return statuses;
+}
+
 }
 }
@@ -20,13 +20,15 @@
 namespace ripple {
 namespace NodeStore {
 
-BatchWriter::BatchWriter (Callback& callback, Scheduler& scheduler)
+BatchWriter::BatchWriter (Callback& callback, Scheduler& scheduler,
+    int maxWriters)
     : m_callback (callback)
     , m_scheduler (scheduler)
+    , m_maxWriters (std::max (1, maxWriters))
     , mWriteLoad (0)
-    , mWritePending (false)
+    , mWriters (0)
+    , mTasks (0)
 {
-    mWriteSet.reserve (batchWritePreallocationSize);
 }
 
 BatchWriter::~BatchWriter ()
@@ -37,16 +39,21 @@ BatchWriter::~BatchWriter ()
 void
 BatchWriter::store (NodeObject::ref object)
 {
-    std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
+    std::unique_lock <decltype(mWriteMutex)> sl (mWriteMutex);
 
-    mWriteSet.push_back (object);
+    mWriteSet.emplace_back (object, clock_type::now ());
 
-    if (! mWritePending)
+    // Apply back-pressure: rather than let the queue grow without
+    // bound, the storing thread takes a turn writing.
+    while (mWriteSet.size () >= batchWriteLimit)
     {
-        mWritePending = true;
-
-        m_scheduler.scheduleTask (*this);
+        if (mWriters < m_maxWriters)
+            writeBatch (sl);
+        else
+            mWriteCondition.wait (sl);
     }
+
+    scheduleWriter (sl);
 }
 
 int
@@ -54,53 +61,84 @@ BatchWriter::getWriteLoad ()
 {
     std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
 
-    return std::max (mWriteLoad, static_cast<int> (mWriteSet.size ()));
+    return mWriteLoad + static_cast<int> (mWriteSet.size ());
 }
 
 void
 BatchWriter::performScheduledTask ()
 {
-    writeBatch ();
+    std::unique_lock <decltype(mWriteMutex)> sl (mWriteMutex);
+
+    // If every writer slot is taken the running writers will drain
+    // the queue, so this task can finish early.
+    while (! mWriteSet.empty () && (mWriters < m_maxWriters))
+        writeBatch (sl);
+
+    --mTasks;
+    mWriteCondition.notify_all ();
 }
 
 void
-BatchWriter::writeBatch ()
+BatchWriter::scheduleWriter (std::unique_lock <LockType>&)
 {
-    for (;;)
+    if (mWriteSet.empty () || (mTasks >= m_maxWriters))
+        return;
+
+    // Add another task only while each one has a full batch to write
+    if ((mTasks == 0) ||
+        (mWriteSet.size () > static_cast<std::size_t> (mTasks) * batchWriteSize))
     {
-        std::vector< std::shared_ptr<NodeObject> > set;
+        ++mTasks;
+        m_scheduler.scheduleTask (*this);
+    }
+}
 
-        set.reserve (batchWritePreallocationSize);
+void
+BatchWriter::writeBatch (std::unique_lock <LockType>& lock)
+{
+    assert (! mWriteSet.empty ());
+    assert (mWriters < m_maxWriters);
 
-        {
-            std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
+    auto const before = clock_type::now ();
 
-            mWriteSet.swap (set);
-            assert (mWriteSet.empty ());
-            mWriteLoad = set.size ();
+    BatchWriteReport report;
+    report.queued = std::chrono::duration_cast <std::chrono::milliseconds>
+        (before - mWriteSet.front ().queued);
 
-            if (set.empty ())
-            {
-                mWritePending = false;
-                mWriteCondition.notify_all ();
+    // Take the oldest objects first, so no object waits behind a
+    // steady stream of newer ones
+    auto const last (mWriteSet.begin () + std::min (
+        mWriteSet.size (), static_cast <std::size_t> (batchWriteSize)));
 
-                // VFALCO NOTE Fix this function to not return from the middle
-                return;
-            }
+    Batch set;
+    set.reserve (last - mWriteSet.begin ());
 
-        }
+    for (auto iter = mWriteSet.begin (); iter != last; ++iter)
+        set.push_back (std::move (iter->object));
 
-        BatchWriteReport report;
-        report.writeCount = set.size();
-        auto const before = std::chrono::steady_clock::now();
+    mWriteSet.erase (mWriteSet.begin (), last);
 
-        m_callback.writeBatch (set);
+    ++mWriters;
+    mWriteLoad += set.size ();
+    report.writeCount = set.size ();
 
-        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
-            (std::chrono::steady_clock::now() - before);
+    lock.unlock ();
 
-        m_scheduler.onBatchWrite (report);
-    }
+    m_callback.writeBatch (set);
+
+    report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+        (clock_type::now () - before);
+
+    lock.lock ();
+
+    --mWriters;
+    mWriteLoad -= set.size ();
+    report.pending = mWriteLoad + static_cast<int> (mWriteSet.size ());
+    mWriteCondition.notify_all ();
+
+    lock.unlock ();
+    m_scheduler.onBatchWrite (report);
+    lock.lock ();
 }
 
 void
@@ -108,7 +146,7 @@ BatchWriter::waitForWriting ()
 {
     std::unique_lock <decltype(mWriteMutex)> sl (mWriteMutex);
 
-    while (mWritePending)
+    while ((mTasks != 0) || (mWriters != 0) || ! mWriteSet.empty ())
         mWriteCondition.wait (sl);
 }
 
@@ -20,7 +20,9 @@
 #ifndef RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 #define RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 
 namespace ripple {
@@ -32,6 +34,16 @@ namespace NodeStore {
     class it not required. A backend can implement its own write batching,
     or skip write batching if doing so yields a performance benefit.
 
+    Objects are handed to the backend in the order they were stored, in
+    batches of at most batchWriteSize.
+    A backend whose writeBatch may be called concurrently can allow several
+    batches in flight, so that encoding overlaps and the database can
+    group-commit them.
+
+    The queue is bounded: once batchWriteLimit objects are waiting, a thread
+    calling store writes a batch itself, or waits for a writer to finish,
+    before returning.
+
     @see Scheduler
 */
 class BatchWriter : private Task
@@ -43,8 +55,13 @@ public:
         virtual void writeBatch (Batch const& batch) = 0;
     };
 
-    /** Create a batch writer. */
-    BatchWriter (Callback& callback, Scheduler& scheduler);
+    /** Create a batch writer.
+
+        @param maxWriters The most calls to writeBatch which may be in
+                          progress at once.
+    */
+    BatchWriter (Callback& callback, Scheduler& scheduler,
+        int maxWriters = 1);
 
     /** Destroy a batch writer.
 
@@ -55,7 +72,8 @@ public:
     /** Store the object.
 
         This will add to the batch and initiate a scheduled task to
-        write the batch out.
+        write the batch out. If too many objects are waiting, the
+        batch is written on the calling thread.
     */
     void store (NodeObject::Ptr const& object);
 
@@ -63,21 +81,38 @@ public:
     int getWriteLoad ();
 
 private:
+    typedef std::recursive_mutex LockType;
+    typedef std::condition_variable_any CondvarType;
+    typedef std::chrono::steady_clock clock_type;
+
     void performScheduledTask ();
-    void writeBatch ();
+    void scheduleWriter (std::unique_lock <LockType>& lock);
+    void writeBatch (std::unique_lock <LockType>& lock);
     void waitForWriting ();
 
 private:
-    typedef std::recursive_mutex LockType;
-    typedef std::condition_variable_any CondvarType;
-
     Callback& m_callback;
     Scheduler& m_scheduler;
+    int const m_maxWriters;
     LockType mWriteMutex;
     CondvarType mWriteCondition;
     int mWriteLoad;
-    bool mWritePending;
-    Batch mWriteSet;
+    int mWriters;
+    int mTasks;
+    // An object waiting to be written, and when it was stored
+    struct Pending
+    {
+        Pending (NodeObject::ref object_, clock_type::time_point queued_)
+            : object (object_)
+            , queued (queued_)
+        {
+        }
+
+        NodeObject::Ptr object;
+        clock_type::time_point queued;
+    };
+
+    std::deque <Pending> mWriteSet;
 };
 
 }
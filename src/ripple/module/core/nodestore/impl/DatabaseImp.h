@@ -41,8 +41,8 @@ public:
     // Larger key/value storage, but not necessarily persistent.
     std::unique_ptr <Backend> m_fastBackend;
 
-    // Positive cache
-    TaggedCache <uint256, NodeObject> m_cache;
+    // Positive cache, sharded since every job thread goes through it
+    ShardedTaggedCache <uint256, NodeObject> m_cache;
 
     // Negative cache
     KeyCache <uint256> m_negCache;
@@ -141,10 +141,24 @@ public:
         return doTimedFetch (hash, false);
     }
 
+    std::vector <NodeObject::Ptr> fetchBatch (
+        std::vector <uint256> const& hashes) override
+    {
+        {
+            // Claim any of these which are queued for a prefetch
+            std::unique_lock <std::mutex> lock (m_readLock);
+            for (auto const& hash : hashes)
+                m_readSet.erase (hash);
+        }
+
+        return doTimedFetchBatch (hashes, false);
+    }
+
     /** Perform a fetch and report the time it took */
     NodeObject::Ptr doTimedFetch (uint256 const& hash, bool isAsync)
     {
         FetchReport report;
+        report.fetchCount = 1;
         report.isAsync = isAsync;
         report.wentToDisk = false;
 
@@ -159,6 +173,27 @@ public:
         return ret;
     }
 
+    /** Perform a batch fetch and report the time it took */
+    std::vector <NodeObject::Ptr> doTimedFetchBatch (
+        std::vector <uint256> const& hashes, bool isAsync)
+    {
+        FetchReport report;
+        report.fetchCount = 0;
+        report.isAsync = isAsync;
+        report.wentToDisk = false;
+
+        auto const before = std::chrono::steady_clock::now();
+        std::vector <NodeObject::Ptr> ret = doFetchBatch (hashes, report);
+        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (std::chrono::steady_clock::now() - before);
+
+        report.wasFound = std::find (ret.begin (), ret.end (),
+            nullptr) == ret.end ();
+        m_scheduler.onFetch (report);
+
+        return ret;
+    }
+
     NodeObject::Ptr doFetch (uint256 const& hash, FetchReport &report)
     {
         // See if the object already exists in the cache
@@ -231,6 +266,96 @@ public:
         return obj;
     }
 
+    std::vector <NodeObject::Ptr> doFetchBatch (
+        std::vector <uint256> const& hashes, FetchReport& report)
+    {
+        std::vector <NodeObject::Ptr> objects (hashes.size ());
+
+        // Indexes of the hashes which are not in either cache
+        std::vector <std::size_t> uncached;
+
+        for (std::size_t i = 0; i < hashes.size (); ++i)
+        {
+            objects [i] = m_cache.fetch (hashes [i]);
+
+            if ((objects [i] == nullptr) &&
+                ! m_negCache.touch_if_exists (hashes [i]))
+            {
+                uncached.push_back (i);
+            }
+        }
+
+        if (uncached.empty ())
+            return objects;
+
+        // Check the database(s).
+
+        report.wentToDisk = true;
+        report.fetchCount = uncached.size ();
+
+        std::vector <bool> foundInFastBackend (hashes.size (), false);
+        std::vector <std::size_t> remaining;
+
+        // Check the fast backend database if we have one
+        //
+        if (m_fastBackend != nullptr)
+        {
+            fetchInternal (*m_fastBackend, hashes, uncached, objects);
+
+            for (auto const i : uncached)
+            {
+                // If we found the object, avoid storing it again later.
+                if (objects [i] != nullptr)
+                    foundInFastBackend [i] = true;
+                else
+                    remaining.push_back (i);
+            }
+        }
+        else
+        {
+            remaining = uncached;
+        }
+
+        // Try the main database for whatever is left.
+        //
+        if (! remaining.empty ())
+            fetchInternal (*m_backend, hashes, remaining, objects);
+
+        for (auto const i : uncached)
+        {
+            uint256 const& hash (hashes [i]);
+
+            if (objects [i] == nullptr)
+            {
+                // Just in case a write occurred
+                objects [i] = m_cache.fetch (hash);
+
+                if (objects [i] == nullptr)
+                {
+                    // We give up
+                    m_negCache.insert (hash);
+                }
+            }
+            else
+            {
+                // Ensure all threads get the same object
+                //
+                m_cache.canonicalize (hash, objects [i]);
+
+                if (! foundInFastBackend [i])
+                {
+                    if (m_fastBackend != nullptr)
+                        m_fastBackend->store (objects [i]);
+
+                    if (m_journal.trace) m_journal.trace <<
+                        "HOS: " << hash << " fetch: in db";
+                }
+            }
+        }
+
+        return objects;
+    }
+
     NodeObject::Ptr fetchInternal (Backend& backend,
         uint256 const& hash)
     {
@@ -238,6 +363,38 @@ public:
 
         Status const status = backend.fetch (hash.begin (), &object);
 
+        checkStatus (status, hash);
+
+        return object;
+    }
+
+    /** Fetch the objects for a subset of hashes with one backend request.
+        @param indexes The positions in `hashes` of the keys to fetch.
+        @param objects [out] Receives each object at the position of its hash.
+    */
+    void fetchInternal (Backend& backend,
+        std::vector <uint256> const& hashes,
+        std::vector <std::size_t> const& indexes,
+        std::vector <NodeObject::Ptr>& objects)
+    {
+        std::vector <void const*> keys;
+        keys.reserve (indexes.size ());
+
+        for (auto const i : indexes)
+            keys.push_back (hashes [i].begin ());
+
+        Batch results;
+        std::vector <Status> const statuses (backend.fetchBatch (keys, results));
+
+        for (std::size_t j = 0; j < indexes.size (); ++j)
+        {
+            checkStatus (statuses [j], hashes [indexes [j]]);
+            objects [indexes [j]] = results [j];
+        }
+    }
+
+    void checkStatus (Status status, uint256 const& hash)
+    {
         switch (status)
         {
         case ok:
@@ -256,8 +413,6 @@ public:
                 "Unknown status=" << status;
             break;
         }
-
-        return object;
     }
 
     //------------------------------------------------------------------------------
@@ -317,7 +472,8 @@ public:
         beast::Thread::setCurrentThreadName ("prefetch");
         while (1)
         {
-            uint256 hash;
+            std::vector <uint256> hashes;
+            hashes.reserve (readBatchSize);
 
             {
                 std::unique_lock <std::mutex> lock (m_readLock);
@@ -343,13 +499,20 @@ public:
                     m_readGenCondVar.notify_all ();
                 }
 
-                hash = *it;
-                m_readSet.erase (it);
-                m_readLast = hash;
+                // Take a run of consecutive keys so the backend
+                // can satisfy them with a single request
+                while ((it != m_readSet.end ()) &&
+                    (hashes.size () < readBatchSize))
+                {
+                    hashes.push_back (*it);
+                    it = m_readSet.erase (it);
+                }
+
+                m_readLast = hashes.back ();
             }
 
-            // Perform the read
-            doTimedFetch (hash, true);
+            // Perform the reads
+            doTimedFetchBatch (hashes, true);
          }
      }
 
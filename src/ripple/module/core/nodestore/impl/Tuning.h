@@ -33,6 +33,9 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Maximum number of keys a prefetch thread reads from the backend at once
+    ,readBatchSize = 64
 };
 
 }
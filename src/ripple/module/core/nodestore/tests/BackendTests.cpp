@@ -69,6 +69,41 @@ public:
                 fetchCopyOfBatch (*backend, &copy, batch);
                 expect (areBatchesEqual (batch, copy), "Should be equal");
             }
+
+            {
+                // Read it back in with a batch fetch
+                Batch copy;
+                fetchBatchCopyOfBatch (*backend, &copy, batch);
+                expect (areBatchesEqual (batch, copy), "Should be equal");
+            }
+
+            {
+                // Batch fetch a mix of stored and missing objects
+                Batch missing;
+                createPredictableBatch (missing, numObjectsToTest, 16, seedValue);
+
+                std::vector <void const*> keys;
+                for (int i = 0; i < missing.size (); ++i)
+                {
+                    keys.push_back (batch [i]->getHash ().cbegin ());
+                    keys.push_back (missing [i]->getHash ().cbegin ());
+                }
+
+                Batch results;
+                std::vector <Status> const statuses (
+                    backend->fetchBatch (keys, results));
+
+                bool found = true;
+                bool notFound = true;
+                for (int i = 0; i < missing.size (); ++i)
+                {
+                    found = found && (results [2 * i] != nullptr) &&
+                        results [2 * i]->isCloneOf (batch [i]);
+                    notFound = notFound && (results [2 * i + 1] == nullptr);
+                }
+                expect (found, "Should find the stored objects");
+                expect (notFound, "Should not find the missing objects");
+            }
         }
 
         {
@@ -88,6 +123,110 @@ public:
 
     //--------------------------------------------------------------------------
 
+    // Make sure a lost index is rebuilt from the data file
+    void testAppendDBRecovery (std::int64_t const seedValue)
+    {
+        std::unique_ptr <Manager> manager (make_Manager ());
+
+        DummyScheduler scheduler;
+
+        testcase ("AppendDB index recovery");
+
+        beast::StringPairArray params;
+        beast::File const path (beast::File::createTempFile ("node_db"));
+        params.set ("type", "appenddb");
+        params.set ("path", path.getFullPathName ());
+
+        Batch batch;
+        createPredictableBatch (batch, 0, numObjectsToTest, seedValue);
+
+        beast::Journal j;
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+            storeBatch (*backend, batch);
+        }
+
+        expect (path.getChildFile ("index.dat").deleteFile (),
+            "Should delete the index");
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+        }
+    }
+
+    // Make sure a partial record left at the end of the data file is discarded
+    void testAppendDBPartialRecord (std::int64_t const seedValue)
+    {
+        std::unique_ptr <Manager> manager (make_Manager ());
+
+        DummyScheduler scheduler;
+
+        testcase ("AppendDB partial record");
+
+        beast::StringPairArray params;
+        beast::File const path (beast::File::createTempFile ("node_db"));
+        params.set ("type", "appenddb");
+        params.set ("path", path.getFullPathName ());
+
+        Batch batch;
+        createPredictableBatch (batch, 0, numObjectsToTest, seedValue);
+
+        Batch more;
+        createPredictableBatch (more, numObjectsToTest, numObjectsToTest, seedValue);
+
+        beast::Journal j;
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+            storeBatch (*backend, batch);
+        }
+
+        beast::File const data (path.getChildFile ("data.dat"));
+        std::int64_t const dataSize (data.getSize ());
+
+        // The start of a record, as a crash in the middle of a write leaves it
+        std::vector <unsigned char> partial (64, 0);
+        partial [32 + 3] = 100;
+        expect (data.appendData (partial.data (), partial.size ()),
+            "Should append a partial record");
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            expect (data.getSize () == dataSize, "Should discard the partial record");
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+
+            // Writes after recovery must be readable
+            storeBatch (*backend, more);
+        }
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, batch);
+            expect (areBatchesEqual (batch, copy), "Should be equal");
+
+            fetchCopyOfBatch (*backend, &copy, more);
+            expect (areBatchesEqual (more, copy), "Should be equal");
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     void run ()
     {
         int const seedValue = 50;
@@ -105,6 +244,12 @@ public:
     #if RIPPLE_ROCKSDB_AVAILABLE
         testBackend ("rocksdb", seedValue);
     #endif
+
+    #if RIPPLE_APPENDDB_AVAILABLE
+        testBackend ("appenddb", seedValue);
+        testAppendDBRecovery (seedValue);
+        testAppendDBPartialRecord (seedValue);
+    #endif
     }
 };
 
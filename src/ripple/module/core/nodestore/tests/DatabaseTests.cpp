@@ -157,6 +157,16 @@ public:
                 expect (areBatchesEqual (batch, copy), "Should be equal");
             }
 
+            {
+                // Re-open the database and read it back in with a batch fetch
+                std::unique_ptr <Database> db (manager->make_Database (
+                    "test", scheduler, j, 2, nodeParams));
+
+                Batch copy;
+                fetchBatchCopyOfBatch (*db, &copy, batch);
+                expect (areBatchesEqual (batch, copy), "Should be equal");
+            }
+
             if (useEphemeralDatabase)
             {
                 // Verify the ephemeral db
@@ -189,6 +199,10 @@ public:
         testNodeStore ("rocksdb", useEphemeralDatabase, true, seedValue);
     #endif
 
+    #if RIPPLE_APPENDDB_AVAILABLE
+        testNodeStore ("appenddb", useEphemeralDatabase, true, seedValue);
+    #endif
+
     #if RIPPLE_ENABLE_SQLITE_BACKEND_TESTS
         testNodeStore ("sqlite", useEphemeralDatabase, true, seedValue);
     #endif
@@ -204,6 +218,10 @@ public:
         testImport ("rocksdb", "rocksdb", seedValue);
     #endif
 
+    #if RIPPLE_APPENDDB_AVAILABLE
+        testImport ("appenddb", "appenddb", seedValue);
+    #endif
+
     #if RIPPLE_HYPERLEVELDB_AVAILABLE
         testImport ("hyperleveldb", "hyperleveldb", seedValue);
     #endif
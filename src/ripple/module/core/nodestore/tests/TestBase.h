@@ -152,6 +152,37 @@ public:
         }
     }
 
+    // Get a copy of a batch in a backend using a single batch fetch
+    void fetchBatchCopyOfBatch (Backend& backend, Batch* pCopy, Batch const& batch)
+    {
+        std::vector <void const*> keys;
+        keys.reserve (batch.size ());
+
+        for (int i = 0; i < batch.size (); ++i)
+            keys.push_back (batch [i]->getHash ().cbegin ());
+
+        Batch results;
+        std::vector <Status> const statuses (backend.fetchBatch (keys, results));
+
+        expect (statuses.size () == batch.size (), "Should have a status per key");
+        expect (results.size () == batch.size (), "Should have a result per key");
+
+        pCopy->clear ();
+        pCopy->reserve (batch.size ());
+
+        for (int i = 0; i < statuses.size (); ++i)
+        {
+            expect (statuses [i] == ok, "Should be ok");
+
+            if (statuses [i] == ok)
+            {
+                expect (results [i] != nullptr, "Should not be null");
+
+                pCopy->push_back (results [i]);
+            }
+        }
+    }
+
     // Store all objects in a batch
     static void storeBatch (Database& db, Batch const& batch)
     {
@@ -184,6 +215,29 @@ public:
                 pCopy->push_back (object);
         }
     }
+
+    // Fetch all the hashes in one batch, into another batch, with one call.
+    static void fetchBatchCopyOfBatch (Database& db,
+                                       Batch* pCopy,
+                                       Batch const& batch)
+    {
+        std::vector <uint256> hashes;
+        hashes.reserve (batch.size ());
+
+        for (int i = 0; i < batch.size (); ++i)
+            hashes.push_back (batch [i]->getHash ());
+
+        Batch const results (db.fetchBatch (hashes));
+
+        pCopy->clear ();
+        pCopy->reserve (batch.size ());
+
+        for (auto const& object : results)
+        {
+            if (object != nullptr)
+                pCopy->push_back (object);
+        }
+    }
 };
 
 }
@@ -122,6 +122,10 @@ public:
         testBackend ("rocksdb", seedValue);
     #endif
 
+    #if RIPPLE_APPENDDB_AVAILABLE
+        testBackend ("appenddb", seedValue);
+    #endif
+
     #if RIPPLE_ENABLE_SQLITE_BACKEND_TESTS
         testBackend ("sqlite", seedValue);
     #endif
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace ripple {
+
+class PublicKeyCacheImp
+{
+private:
+    enum
+    {
+        cacheTargetSize = 4096,
+        cacheTargetSeconds = 300
+    };
+
+    struct Stats
+    {
+        template <class Handler>
+        Stats (Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge ("size"))
+            , hits (collector->make_counter ("hits"))
+            , misses (collector->make_counter ("misses"))
+            , reportedHits (0)
+            , reportedMisses (0)
+        {
+        }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Counter hits;
+        beast::insight::Counter misses;
+        std::uint64_t reportedHits;
+        std::uint64_t reportedMisses;
+    };
+
+    typedef ShardedTaggedCache <std::string, CKey const> cache_type;
+
+    cache_type m_cache;
+    std::atomic <std::uint64_t> m_hits;
+    std::atomic <std::uint64_t> m_misses;
+
+    // Guards m_stats, which the collector's thread reads
+    std::mutex m_statsMutex;
+    std::unique_ptr <Stats> m_stats;
+
+public:
+    PublicKeyCacheImp ()
+        : m_cache ("PublicKeyCache", cacheTargetSize, cacheTargetSeconds,
+            get_seconds_clock (), beast::Journal ())
+        , m_hits (0)
+        , m_misses (0)
+    {
+    }
+
+    static PublicKeyCacheImp& getInstance ()
+    {
+        static PublicKeyCacheImp instance;
+        return instance;
+    }
+
+    PublicKeyCache::pointer fetch (Blob const& publicKey)
+    {
+        if (publicKey.empty ())
+            return PublicKeyCache::pointer ();
+
+        std::string const key (publicKey.begin (), publicKey.end ());
+
+        PublicKeyCache::pointer ret (m_cache.fetch (key));
+
+        if (ret)
+        {
+            ++m_hits;
+            return ret;
+        }
+
+        ++m_misses;
+
+        auto decoded (std::make_shared <CKey> ());
+
+        if (! decoded->SetPubKey (publicKey))
+            return PublicKeyCache::pointer ();
+
+        ret = decoded;
+        m_cache.canonicalize (key, ret);
+        return ret;
+    }
+
+    void sweep ()
+    {
+        m_cache.sweep ();
+    }
+
+    void setCollector (beast::insight::Collector::ptr const& collector)
+    {
+        std::unique_ptr <Stats> stats;
+
+        if (collector)
+            stats = std::make_unique <Stats> (std::bind (
+                &PublicKeyCacheImp::collect_metrics, this), collector);
+
+        {
+            std::lock_guard <std::mutex> lock (m_statsMutex);
+            m_stats.swap (stats);
+        }
+
+        // The old hook is released outside the lock, since releasing it
+        // may wait for the collector, which may be calling collect_metrics
+    }
+
+private:
+    void collect_metrics ()
+    {
+        std::lock_guard <std::mutex> lock (m_statsMutex);
+
+        if (! m_stats)
+            return;
+
+        std::uint64_t const hits (m_hits.load ());
+        std::uint64_t const misses (m_misses.load ());
+
+        m_stats->hits.increment (hits - m_stats->reportedHits);
+        m_stats->misses.increment (misses - m_stats->reportedMisses);
+        m_stats->reportedHits = hits;
+        m_stats->reportedMisses = misses;
+
+        m_stats->size.set (m_cache.getCacheSize ());
+    }
+};
+
+//------------------------------------------------------------------------------
+
+PublicKeyCache::pointer PublicKeyCache::fetch (Blob const& publicKey)
+{
+    return PublicKeyCacheImp::getInstance ().fetch (publicKey);
+}
+
+void PublicKeyCache::sweep ()
+{
+    PublicKeyCacheImp::getInstance ().sweep ();
+}
+
+void PublicKeyCache::setCollector (
+    beast::insight::Collector::ptr const& collector)
+{
+    PublicKeyCacheImp::getInstance ().setCollector (collector);
+}
+
+} // ripple
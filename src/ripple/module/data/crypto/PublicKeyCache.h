@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PUBLICKEYCACHE_H_INCLUDED
+#define RIPPLE_PUBLICKEYCACHE_H_INCLUDED
+
+namespace ripple {
+
+class CKey;
+
+/** A cache of decoded public keys.
+
+    Decoding a serialized public key into an EC_KEY decompresses a curve
+    point, which costs about as much as the signature check itself. The
+    same validators and accounts sign again and again, so decoded keys are
+    kept here, keyed by their serialized bytes. Every signature check made
+    through RippleAddress uses this cache.
+
+    Cached keys are only used to verify and are never modified, so one key
+    may be used by several threads at once.
+*/
+class PublicKeyCache
+{
+public:
+    typedef std::shared_ptr <CKey const> pointer;
+
+    /** Return the decoded key, or an empty pointer if it is malformed. */
+    static pointer fetch (Blob const& publicKey);
+
+    /** Remove keys which have not been used recently. */
+    static void sweep ();
+
+    /** Report hits, misses and size through the given collector.
+        Passing a null collector stops reporting, and must be done before
+        the collector is destroyed.
+    */
+    static void setCollector (beast::insight::Collector::ptr const& collector);
+};
+
+} // ripple
+
+#endif
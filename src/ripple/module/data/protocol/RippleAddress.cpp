@@ -167,22 +167,18 @@ void RippleAddress::setNodePublic (Blob const& vPublic)
 
 bool RippleAddress::verifyNodePublic (uint256 const& hash, Blob const& vchSig, ECDSA fullyCanonical) const
 {
-    CKey    pubkey  = CKey ();
-    bool    bVerified;
+    if (!isCanonicalECDSASig (vchSig, fullyCanonical))
+        return false;
 
-    bVerified = isCanonicalECDSASig (vchSig, fullyCanonical);
+    PublicKeyCache::pointer pubkey = PublicKeyCache::fetch (getNodePublic ());
 
-    if (bVerified && !pubkey.SetPubKey (getNodePublic ()))
+    if (!pubkey)
     {
         // Failed to set public key.
-        bVerified   = false;
-    }
-    else
-    {
-        bVerified   = pubkey.Verify (hash, vchSig);
+        return false;
     }
 
-    return bVerified;
+    return pubkey->Verify (hash, vchSig);
 }
 
 bool RippleAddress::verifyNodePublic (uint256 const& hash, const std::string& strSig, ECDSA fullyCanonical) const
@@ -451,22 +447,19 @@ void RippleAddress::setAccountPublic (const RippleAddress& generator, int seq)
 
 bool RippleAddress::accountPublicVerify (uint256 const& uHash, Blob const& vucSig, ECDSA fullyCanonical) const
 {
-    CKey        ckPublic;
+    if (!isCanonicalECDSASig (vucSig, fullyCanonical))
+        return false;
 
-    bool        bVerified = isCanonicalECDSASig (vucSig, fullyCanonical);
+    PublicKeyCache::pointer ckPublic = PublicKeyCache::fetch (getAccountPublic ());
 
-    if (bVerified && !ckPublic.SetPubKey (getAccountPublic ()))
+    if (!ckPublic)
     {
         // Bad private key.
         WriteLog (lsWARNING, RippleAddress) << "accountPublicVerify: Bad private key.";
-        bVerified   = false;
-    }
-    else
-    {
-        bVerified   = ckPublic.Verify (uHash, vucSig);
+        return false;
     }
 
-    return bVerified;
+    return ckPublic->Verify (uHash, vucSig);
 }
 
 RippleAddress RippleAddress::createAccountID (const uint160& uiAccountID)
@@ -913,6 +906,12 @@ public:
         expect (!naAccountPublic0.accountPublicVerify (uHash, vucTextSig, ECDSA::not_strict), "Anti-verify failed.");
         expect (!naAccountPublic0.accountPublicVerify (uHash, vucTextSig, ECDSA::strict), "Anti-verify failed.");
 
+        // Check the decoded key cache.
+        PublicKeyCache::pointer cached = PublicKeyCache::fetch (naAccountPublic1.getAccountPublic ());
+        expect (cached && (cached->GetPubKey () == naAccountPublic1.getAccountPublic ()), "Key cache decode failed.");
+        expect (cached == PublicKeyCache::fetch (naAccountPublic1.getAccountPublic ()), "Key cache miss.");
+        expect (!PublicKeyCache::fetch (Blob (33, 0)), "Key cache accepted a bad key.");
+
         // Check account encryption.
         Blob vucTextCipher
             = naAccountPrivate0.accountPrivateEncrypt (naAccountPublic1, vucTextSrc);
@@ -23,6 +23,59 @@ namespace ripple {
 
 SETUP_LOG (STAmount)
 
+// Computes (multiplier * multiplicand + addend) / divisor using BIGNUM.
+// This is the reference implementation for mulDiv. As with BN_get_word,
+// a quotient which does not fit in 64 bits is returned as all ones.
+static std::uint64_t mulDivBigNum (std::uint64_t multiplier,
+    std::uint64_t multiplicand, std::uint64_t addend, std::uint64_t divisor)
+{
+    CBigNum v;
+
+    if ((BN_add_word64 (&v, multiplier) != 1) ||
+            (BN_mul_word64 (&v, multiplicand) != 1) ||
+            ((addend != 0) && (BN_add_word64 (&v, addend) != 1)) ||
+            (BN_div_word64 (&v, divisor) == ((std::uint64_t) - 1)))
+    {
+        throw std::runtime_error ("internal bn error");
+    }
+
+    // 10^16 <= result <= 10^18 for normalized operands
+    assert (BN_num_bytes (&v) <= 64);
+
+    return v.getuint64 ();
+}
+
+#ifdef __SIZEOF_INT128__
+
+// Computes (multiplier * multiplicand + addend) / divisor without heap
+// allocation. The results are identical to mulDivBigNum.
+static std::uint64_t mulDiv (std::uint64_t multiplier,
+    std::uint64_t multiplicand, std::uint64_t addend, std::uint64_t divisor)
+{
+    if (divisor == 0)
+        throw std::runtime_error ("internal bn error");
+
+    // The product is at most (2^64-1)^2, leaving room for the addend
+    unsigned __int128 v = static_cast <unsigned __int128> (multiplier) * multiplicand;
+    v += addend;
+    v /= divisor;
+
+    if (v > std::numeric_limits <std::uint64_t>::max ())
+        return std::numeric_limits <std::uint64_t>::max ();
+
+    return static_cast <std::uint64_t> (v);
+}
+
+#else
+
+static std::uint64_t mulDiv (std::uint64_t multiplier,
+    std::uint64_t multiplicand, std::uint64_t addend, std::uint64_t divisor)
+{
+    return mulDivBigNum (multiplier, multiplicand, addend, divisor);
+}
+
+#endif
+
 std::uint64_t STAmount::uRateOne  = STAmount::getRate (STAmount (1), STAmount (1));
 
 bool STAmount::issuerFromString (uint160& uDstIssuer, const std::string& sIssuer)
@@ -948,19 +1001,10 @@ STAmount STAmount::divide (const STAmount& num, const STAmount& den, const uint1
         }
 
     // Compute (numerator * 10^17) / denominator
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, numVal) != 1) ||
-            (BN_mul_word64 (&v, tenTo17) != 1) ||
-            (BN_div_word64 (&v, denVal) == ((std::uint64_t) - 1)))
-    {
-        throw std::runtime_error ("internal bn error");
-    }
-
     // 10^16 <= quotient <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
+    std::uint64_t const v = mulDiv (numVal, tenTo17, 0, denVal);
 
-    return STAmount (uCurrencyID, uIssuerID, v.getuint64 () + 5,
+    return STAmount (uCurrencyID, uIssuerID, v + 5,
                      numOffset - denOffset - 17, num.mIsNegative != den.mIsNegative);
 }
 
@@ -1006,19 +1050,9 @@ STAmount STAmount::multiply (const STAmount& v1, const STAmount& v2, const uint1
 
     // Compute (numerator * denominator) / 10^14 with rounding
     // 10^16 <= result <= 10^18
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, value1) != 1) ||
-            (BN_mul_word64 (&v, value2) != 1) ||
-            (BN_div_word64 (&v, tenTo14) == ((std::uint64_t) - 1)))
-    {
-        throw std::runtime_error ("internal bn error");
-    }
-
-    // 10^16 <= product <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
+    std::uint64_t const v = mulDiv (value1, value2, 0, tenTo14);
 
-    return STAmount (uCurrencyID, uIssuerID, v.getuint64 () + 7, offset1 + offset2 + 14,
+    return STAmount (uCurrencyID, uIssuerID, v + 7, offset1 + offset2 + 14,
                      v1.mIsNegative != v2.mIsNegative);
 }
 
@@ -1692,6 +1726,64 @@ public:
 
     //--------------------------------------------------------------------------
 
+    static std::uint64_t rand64 ()
+    {
+        std::uint64_t r = rand ();
+        r = (r << 31) ^ rand ();
+        r = (r << 31) ^ rand ();
+        return r;
+    }
+
+    // A normalized IOU mantissa, or a native value scaled up into range
+    static std::uint64_t randMantissa ()
+    {
+        return STAmount::cMinValue + rand64 () % (10 * STAmount::cMinValue);
+    }
+
+    void checkMulDiv (std::uint64_t multiplier, std::uint64_t multiplicand,
+        std::uint64_t addend, std::uint64_t divisor, int& failures)
+    {
+        std::uint64_t const fast = mulDiv (multiplier, multiplicand, addend, divisor);
+        std::uint64_t const reference = mulDivBigNum (multiplier, multiplicand, addend, divisor);
+
+        if ((fast != reference) && (failures++ == 0))
+        {
+            log << "mulDiv (" << multiplier << ", " << multiplicand <<
+                ", " << addend << ", " << divisor << ") = " << fast <<
+                ", expected " << reference;
+        }
+    }
+
+    void testMulDiv ()
+    {
+        testcase ("mulDiv");
+
+        int failures = 0;
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            std::uint64_t const a = randMantissa ();
+            std::uint64_t const b = randMantissa ();
+
+            // As used by multiply and mulRound
+            checkMulDiv (a, b, 0, tenTo14, failures);
+            checkMulDiv (a, b, tenTo14m1, tenTo14, failures);
+
+            // As used by divide, divRound and getRate
+            checkMulDiv (a, tenTo17, 0, b, failures);
+            checkMulDiv (a, tenTo17, b - 1, b, failures);
+
+            // Arbitrary operands, including quotients which overflow
+            std::uint64_t const divisor = rand64 () >> (rand () % 64);
+            if (divisor != 0)
+                checkMulDiv (rand64 (), rand64 (), rand64 (), divisor, failures);
+        }
+
+        expect (failures == 0, "mulDiv differs from BIGNUM");
+    }
+
+    //--------------------------------------------------------------------------
+
     template <class Cond>
     bool
     expect (Cond cond, beast::String const& s)
@@ -1811,6 +1903,7 @@ public:
         testNativeCurrency ();
         testCustomCurrency ();
         testArithmetic ();
+        testMulDiv ();
         testUnderflow ();
         testRounding ();
     }
@@ -244,21 +244,10 @@ STAmount STAmount::mulRound (const STAmount& v1, const STAmount& v2,
     bool resultNegative = v1.mIsNegative != v2.mIsNegative;
     // Compute (numerator * denominator) / 10^14 with rounding
     // 10^16 <= result <= 10^18
-    CBigNum v;
+    // rounding down is automatic when we divide
+    std::uint64_t amount = mulDiv (value1, value2,
+        (resultNegative != roundUp) ? tenTo14m1 : 0, tenTo14);
 
-    if ((BN_add_word64 (&v, value1) != 1) || (BN_mul_word64 (&v, value2) != 1))
-        throw std::runtime_error ("internal bn error");
-
-    if (resultNegative != roundUp) // rounding down is automatic when we divide
-        BN_add_word64 (&v, tenTo14m1);
-
-    if  (BN_div_word64 (&v, tenTo14) == ((std::uint64_t) - 1))
-        throw std::runtime_error ("internal bn error");
-
-    // 10^16 <= product <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
-
-    std::uint64_t amount = v.getuint64 ();
     int offset = offset1 + offset2 + 14;
     canonicalizeRound (uCurrencyID.isZero (), amount, offset, resultNegative != roundUp);
     return STAmount (uCurrencyID, uIssuerID, amount, offset, resultNegative);
@@ -293,21 +282,10 @@ STAmount STAmount::divRound (const STAmount& num, const STAmount& den,
 
     bool resultNegative = num.mIsNegative != den.mIsNegative;
     // Compute (numerator * 10^17) / denominator
-    CBigNum v;
-
-    if ((BN_add_word64 (&v, numVal) != 1) || (BN_mul_word64 (&v, tenTo17) != 1))
-        throw std::runtime_error ("internal bn error");
-
-    if (resultNegative != roundUp) // Rounding down is automatic when we divide
-        BN_add_word64 (&v, denVal - 1);
-
-    if (BN_div_word64 (&v, denVal) == ((std::uint64_t) - 1))
-        throw std::runtime_error ("internal bn error");
-
-    // 10^16 <= quotient <= 10^18
-    assert (BN_num_bytes (&v) <= 64);
+    // Rounding down is automatic when we divide
+    std::uint64_t amount = mulDiv (numVal, tenTo17,
+        (resultNegative != roundUp) ? (denVal - 1) : 0, denVal);
 
-    std::uint64_t amount = v.getuint64 ();
     int offset = numOffset - denOffset - 17;
     canonicalizeRound (uCurrencyID.isZero (), amount, offset, resultNegative != roundUp);
     return STAmount (uCurrencyID, uIssuerID, amount, offset, resultNegative);
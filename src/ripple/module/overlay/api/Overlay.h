@@ -29,6 +29,7 @@
 #include <beast/utility/PropertyStream.h>
 
 #include <beast/cxx14/type_traits.h> // <type_traits>
+#include <chrono>
 
 namespace ripple {
 
@@ -74,6 +75,48 @@ public:
     // Peer 64-bit ID function
     virtual Peer::ptr findPeerByShortID (Peer::ShortId const& id) = 0;
 
+    /** Broadcast a message to every active peer.
+        The message is serialized once by the caller and the same immutable
+        buffer is queued on each peer, so broadcasting costs one reference
+        count per peer regardless of the message size.
+    */
+    void
+    broadcast (Message::pointer const& m)
+    {
+        broadcast_if (m, always ());
+    }
+
+    /** Broadcast a message to the active peers matching a predicate.
+        The predicate is called as `bool (Peer::ptr const&)`, see
+        predicates.h. Neither the message nor the predicate is copied.
+    */
+    template <class Predicate>
+    void
+    broadcast_if (Message::pointer const& m, Predicate const& pred)
+    {
+        clock_type::time_point const start (clock_type::now ());
+        PeerSequence const peers (getActivePeers ());
+        std::size_t sent (0);
+        for (auto const& peer : peers)
+        {
+            if (pred (peer))
+            {
+                peer->sendPacket (m, false);
+                ++sent;
+            }
+        }
+        onBroadcast (*m, sent, clock_type::now () - start);
+    }
+
+    /** Broadcast a message to the active peers not matching a predicate. */
+    template <class Predicate>
+    void
+    broadcast_if_not (Message::pointer const& m, Predicate const& pred)
+    {
+        broadcast_if (m, [&pred](Peer::ptr const& peer)
+            { return ! pred (peer); });
+    }
+
     /** Visit every active peer and return a value
         The functor must:
         - Be callable as:
@@ -124,6 +167,26 @@ public:
         for(PeerSequence::const_iterator i = peers.begin(); i != peers.end(); ++i)
             f (*i);
     }
+
+protected:
+    typedef std::chrono::steady_clock clock_type;
+
+    /** Called after a broadcast has been queued on every selected peer.
+        @param m The message which was sent.
+        @param peers The number of peers the message was queued on.
+        @param elapsed The time taken to fan the message out.
+    */
+    virtual void onBroadcast (Message const& m, std::size_t peers,
+        clock_type::duration elapsed) = 0;
+
+private:
+    struct always
+    {
+        bool operator() (Peer::ptr const&) const
+        {
+            return true;
+        }
+    };
 };
 
 }
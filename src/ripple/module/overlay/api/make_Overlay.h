@@ -28,6 +28,7 @@
 
 #include <beast/threads/Stoppable.h>
 #include <beast/module/core/files/File.h>
+#include <beast/insight/Collector.h>
 
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/ssl/context.hpp>
@@ -46,6 +47,7 @@ namespace ripple {
     @param resolver
     @param io_service
     @param context
+    @param collector
 */
 std::unique_ptr <Overlay>
 make_Overlay (
@@ -55,7 +57,8 @@ make_Overlay (
     beast::File const& pathToDbFileOrDirectory,
     Resolver& resolver,
     boost::asio::io_service& io_service,
-    boost::asio::ssl::context& ssl_context);
+    boost::asio::ssl::context& ssl_context,
+    beast::insight::Collector::ptr const& collector);
 
 } // ripple
 
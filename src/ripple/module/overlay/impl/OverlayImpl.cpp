@@ -83,7 +83,8 @@ OverlayImpl::OverlayImpl (Stoppable& parent,
     beast::File const& pathToDbFileOrDirectory,
     Resolver& resolver,
     boost::asio::io_service& io_service,
-    boost::asio::ssl::context& ssl_context)
+    boost::asio::ssl::context& ssl_context,
+    beast::insight::Collector::ptr const& collector)
     : Overlay (parent)
     , m_child_count (1)
     , m_journal (LogPartition::getJournal <PeersLog> ())
@@ -98,6 +99,9 @@ OverlayImpl::OverlayImpl (Stoppable& parent,
     , m_io_service (io_service)
     , m_ssl_context (ssl_context)
     , m_resolver (resolver)
+    , m_broadcastFanout (collector->make_event ("broadcast_fanout"))
+    , m_broadcastSends (collector->make_counter ("broadcast_sends"))
+    , m_broadcastBytes (collector->make_counter ("broadcast_bytes"))
 {
 }
 
@@ -568,6 +572,15 @@ OverlayImpl::getActivePeers ()
     return ret;
 }
 
+void
+OverlayImpl::onBroadcast (Message const& m, std::size_t peers,
+    clock_type::duration elapsed)
+{
+    m_broadcastFanout.notify (elapsed);
+    m_broadcastSends += peers;
+    m_broadcastBytes += peers * m.getBuffer ().size ();
+}
+
 Peer::ptr
 OverlayImpl::findPeerByShortID (Peer::ShortId const& id)
 {
@@ -589,10 +602,11 @@ make_Overlay (
     beast::File const& pathToDbFileOrDirectory, 
     Resolver& resolver,
     boost::asio::io_service& io_service,
-    boost::asio::ssl::context& ssl_context)
+    boost::asio::ssl::context& ssl_context,
+    beast::insight::Collector::ptr const& collector)
 {
     return std::make_unique <OverlayImpl> (parent, resourceManager, siteFiles,
-        pathToDbFileOrDirectory, resolver, io_service, ssl_context);
+        pathToDbFileOrDirectory, resolver, io_service, ssl_context, collector);
 }
 
 }
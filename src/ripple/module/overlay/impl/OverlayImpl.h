@@ -96,6 +96,13 @@ public:
     /** Monotically increasing identifiers for peers */
     beast::Atomic <Peer::ShortId> m_nextShortId;
 
+    /** Time taken to queue a broadcast on every selected peer */
+    beast::insight::Event m_broadcastFanout;
+
+    /** Number of peer sends and bytes queued by broadcasts */
+    beast::insight::Counter m_broadcastSends;
+    beast::insight::Counter m_broadcastBytes;
+
     //--------------------------------------------------------------------------
 
     OverlayImpl (Stoppable& parent,
@@ -104,7 +111,8 @@ public:
         beast::File const& pathToDbFileOrDirectory,
         Resolver& resolver,
         boost::asio::io_service& io_service,
-        boost::asio::ssl::context& ssl_context);
+        boost::asio::ssl::context& ssl_context,
+        beast::insight::Collector::ptr const& collector);
 
     ~OverlayImpl ();
 
@@ -219,6 +227,11 @@ public:
 
     Peer::ptr
     findPeerByShortID (Peer::ShortId const& id);
+
+private:
+    void
+    onBroadcast (Message const& m, std::size_t peers,
+        clock_type::duration elapsed) override;
 };
 
 } // ripple
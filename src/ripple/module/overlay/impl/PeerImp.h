@@ -126,6 +126,15 @@ private:
     }
 
 public:
+    enum
+    {
+        /** Most bytes of queued messages gathered into one write.
+            Each write through the SSL stream becomes at least one record,
+            so small messages are copied together and sent at once.
+        */
+        sendBatchBytes = 64 * 1024
+    };
+
     /** Current state */
     enum State
     {
@@ -197,8 +206,14 @@ public:
     boost::asio::deadline_timer         m_timer;
 
     std::vector<uint8_t>                m_readBuffer;
-    std::list<Message::pointer>   mSendQ;
-    Message::pointer              mSendingPacket;
+    std::deque<Message::pointer>  mSendQ;
+    Message::pointer              mSendingPacket;   // Written alone, if large
+    std::vector<uint8_t>          m_writeBuffer;    // Small messages gathered
+    bool                          m_writing;
+
+    // Reported by json (), which may be called off the strand
+    std::atomic <std::size_t>     m_sendQueueSize;
+    std::atomic <std::size_t>     m_sendBytesInFlight;
     protocol::TMStatusChange            mLastStatus;
     protocol::TMHello                   mHello;
 
@@ -238,6 +253,9 @@ public:
             , m_minLedger (0)
             , m_maxLedger (0)
             , m_timer (m_owned_socket.get_io_service())
+            , m_writing (false)
+            , m_sendQueueSize (0)
+            , m_sendBytesInFlight (0)
             , m_slot (slot)
             , m_was_canceled (false)
     {
@@ -275,6 +293,9 @@ public:
             , m_minLedger (0)
             , m_maxLedger (0)
             , m_timer (io_service)
+            , m_writing (false)
+            , m_sendQueueSize (0)
+            , m_sendBytesInFlight (0)
             , m_slot (slot)
             , m_was_canceled (false)
     {
@@ -347,6 +368,7 @@ public:
                                      " detached: " << rsn;
 
             mSendQ.clear ();
+            m_sendQueueSize = 0;
 
             (void) m_timer.cancel ();
 
@@ -466,14 +488,11 @@ public:
                 return;
             }
 
-            if (mSendingPacket)
-            {
-                mSendQ.push_back (packet);
-            }
-            else
-            {
-                sendPacketForce (packet);
-            }
+            mSendQ.push_back (packet);
+            m_sendQueueSize = mSendQ.size ();
+
+            if (!m_writing)
+                startWrite ();
         }
     }
 
@@ -541,6 +560,15 @@ public:
         if (!!m_closedLedgerHash)
             ret["ledger"] = to_string (m_closedLedgerHash);
 
+        std::size_t const sendQueue = m_sendQueueSize;
+        std::size_t const sendBytes = m_sendBytesInFlight;
+
+        if (sendQueue != 0)
+            ret["send_queue"] = static_cast <Json::UInt> (sendQueue);
+
+        if (sendBytes != 0)
+            ret["send_bytes"] = static_cast <Json::UInt> (sendBytes);
+
         if (mLastStatus.has_newstatus ())
         {
             switch (mLastStatus.newstatus ())
@@ -675,6 +703,8 @@ private:
         // Call on IO strand
 
         mSendingPacket.reset ();
+        m_writing = false;
+        m_sendBytesInFlight = 0;
 
         if (ec == boost::asio::error::operation_aborted)
             return;
@@ -689,16 +719,7 @@ private:
             return;
         }
 
-        if (!mSendQ.empty ())
-        {
-            Message::pointer packet = mSendQ.front ();
-
-            if (packet)
-            {
-                sendPacketForce (packet);
-                mSendQ.pop_front ();
-            }
-        }
+        startWrite ();
     }
 
     void handleReadHeader (boost::system::error_code const& ec,
@@ -1185,21 +1206,58 @@ private:
         }
     }
 
-    void sendPacketForce (const Message::pointer& packet)
+    /** Write the queued messages.
+
+        A message too large to share a batch is written from its own buffer.
+        Otherwise, as many queued messages as fit in sendBatchBytes are
+        copied into one buffer and written together.
+    */
+    void startWrite ()
     {
         // must be on IO strand
-        if (!m_detaching)
+        if (m_detaching || mSendQ.empty ())
+            return;
+
+        std::size_t const frontBytes = mSendQ.front ()->getBuffer ().size ();
+
+        if (mSendQ.size () == 1 || frontBytes >= sendBatchBytes)
+        {
+            mSendingPacket = mSendQ.front ();
+            mSendQ.pop_front ();
+            writeBuffer (boost::asio::buffer (mSendingPacket->getBuffer ()));
+        }
+        else
         {
-            mSendingPacket = packet;
+            m_writeBuffer.clear ();
 
-            boost::asio::async_write (getStream (),
-                boost::asio::buffer (packet->getBuffer ()),
-                m_strand.wrap (std::bind (
-                    &PeerImp::handleWrite,
-                    std::static_pointer_cast <PeerImp> (shared_from_this ()),
-                    beast::asio::placeholders::error,
-                    beast::asio::placeholders::bytes_transferred)));
+            while (!mSendQ.empty ())
+            {
+                std::vector<uint8_t> const& buffer = mSendQ.front ()->getBuffer ();
+
+                if ((m_writeBuffer.size () + buffer.size ()) > sendBatchBytes)
+                    break;
+
+                m_writeBuffer.insert (m_writeBuffer.end (), buffer.begin (), buffer.end ());
+                mSendQ.pop_front ();
+            }
+
+            writeBuffer (boost::asio::buffer (m_writeBuffer));
         }
+
+        m_sendQueueSize = mSendQ.size ();
+    }
+
+    void writeBuffer (boost::asio::const_buffer buffer)
+    {
+        m_writing = true;
+        m_sendBytesInFlight = boost::asio::buffer_size (buffer);
+
+        boost::asio::async_write (getStream (), boost::asio::buffer (buffer),
+            m_strand.wrap (std::bind (
+                &PeerImp::handleWrite,
+                std::static_pointer_cast <PeerImp> (shared_from_this ()),
+                beast::asio::placeholders::error,
+                beast::asio::placeholders::bytes_transferred)));
     }
 
     /** Hashes the latest finished message from an SSL stream
@@ -1531,16 +1589,19 @@ private:
             if (m_clusterNode)
                 flags |= SF_TRUSTED | SF_SIGGOOD;
 
-            if (getApp().getJobQueue().getJobCount(jtTRANSACTION) > 100)
+            if ((getApp().getJobQueue().getJobCount(jtTRANSACTION) +
+                    getApp().getSigVerifier().getPendingCount()) > 100)
                 m_journal.info << "Transaction queue is full";
             else if (getApp().getLedgerMaster().getValidatedLedgerAge() > 240)
                 m_journal.trace << "No new transactions until synchronized";
+            else if (is_bit_set (flags, SF_SIGGOOD))
+                queueTransaction (flags, stx,
+                    std::weak_ptr<Peer> (shared_from_this ()));
             else
-                getApp().getJobQueue ().addJob (jtTRANSACTION,
-                    "recvTransaction->checkTransaction",
+                getApp().getSigVerifier ().verify (stx,
                     std::bind (
-                        &PeerImp::checkTransaction, std::placeholders::_1,
-                        flags, stx,
+                        &PeerImp::checkedTransaction, std::placeholders::_1,
+                        std::placeholders::_2, flags,
                         std::weak_ptr<Peer> (shared_from_this ())));
 
     #ifndef TRUST_NETWORK
@@ -1859,8 +1920,9 @@ private:
 
         protocol::TMLedgerData& packet = *pPacket;
 
+        // The node data is viewed in place, pPacket outlives its use
         std::list<SHAMapNode> nodeIDs;
-        std::list< Blob > nodeData;
+        std::list<const_byte_view> nodeData;
         for (int i = 0; i < packet.nodes ().size (); ++i)
         {
             const protocol::TMLedgerNode& node = packet.nodes (i);
@@ -1873,7 +1935,7 @@ private:
             }
 
             nodeIDs.push_back (SHAMapNode (node.nodeid ().data (), node.nodeid ().size ()));
-            nodeData.push_back (Blob (node.nodedata ().begin (), node.nodedata ().end ()));
+            nodeData.push_back (make_byte_view (node.nodedata ()));
         }
 
         SHAMapAddNode san;
@@ -2617,6 +2679,29 @@ private:
         }
     }
 
+    // Called by the SigVerifier once the signature has been checked
+    static void checkedTransaction (SerializedTransaction::ref stx, bool good,
+        int flags, std::weak_ptr<Peer> peer)
+    {
+        if (! good)
+        {
+            charge (peer, Resource::feeInvalidSignature);
+            return;
+        }
+
+        queueTransaction (flags | SF_SIGGOOD, stx, peer);
+    }
+
+    static void queueTransaction (int flags, SerializedTransaction::ref stx,
+        std::weak_ptr<Peer> peer)
+    {
+        getApp().getJobQueue ().addJob (jtTRANSACTION,
+            "recvTransaction->checkTransaction",
+            std::bind (
+                &PeerImp::checkTransaction, std::placeholders::_1,
+                flags, stx, peer));
+    }
+
     static void checkTransaction (Job&, int flags, SerializedTransaction::pointer stx, std::weak_ptr<Peer> peer)
     {
     #ifndef TRUST_NETWORK
@@ -2721,9 +2806,9 @@ private:
             if (getApp().getHashRouter ().swapSet (
                 proposal->getSuppressionID (), peers, SF_RELAYED))
             {
-                pPeers->foreach (send_if_not (
+                pPeers->broadcast_if_not (
                     std::make_shared<Message> (set, protocol::mtPROPOSE_LEDGER),
-                    peer_in_set(peers)));
+                    peer_in_set(peers));
 	    }
         }
         else
@@ -2773,9 +2858,9 @@ private:
             if (getApp().getOPs ().recvValidation (val, source) &&
                     getApp().getHashRouter ().swapSet (signingHash, peers, SF_RELAYED))
             {
-                pPeers->foreach (send_if_not (
+                pPeers->broadcast_if_not (
                     std::make_shared<Message> (*packet, protocol::mtVALIDATION),
-                    peer_in_set(peers)));
+                    peer_in_set(peers));
             }
         }
 
@@ -36,6 +36,12 @@ Json::Value RPCHandler::doPathFind (Json::Value params, Resource::Charge& loadTy
     if (sSubCommand == "create")
     {
         loadType = Resource::feeHighBurdenRPC;
+
+        // Stop any update still working on the request being replaced
+        PathRequest::pointer request = mInfoSub->getPathRequest ();
+        if (request)
+            request->cancel ();
+
         mInfoSub->clearPathRequest ();
         return getApp().getPathRequests().makePathRequest (mInfoSub, lpLedger, params);
     }
@@ -59,16 +59,16 @@ struct Entry : public beast::List <Entry>::Node
     }
 
     // Balance including remote contributions
-    int balance (clock_type::rep const now)
+    int balance (clock_type::rep const now) const
     {
-        return local_balance.value (now) + remote_balance;
+        return local_balance.value (now) + remote_balance.load ();
     }
 
     // Add a charge and return normalized balance
     // including contributions from imports.
     int add (int charge, clock_type::rep const now)
     {
-        return local_balance.add (charge, now) + remote_balance;
+        return local_balance.add (charge, now) + remote_balance.load ();
     }
 
     // Back pointer to the map key (bit of a hack here)
@@ -77,17 +77,19 @@ struct Entry : public beast::List <Entry>::Node
     // Number of Consumer references
     int refcount;
 
-    // Exponentially decaying balance of resource consumption
-    DecayingSample <decayWindowSeconds> local_balance;
+    // Exponentially decaying balance of resource consumption.
+    // Charges update this without holding the Logic lock.
+    AtomicDecayingSample <decayWindowSeconds> local_balance;
 
-    // Normalized balance contribution from imports
-    int remote_balance;
+    // Normalized balance contribution from imports.
+    // Only changed under the Logic lock, but read without it.
+    std::atomic <int> remote_balance;
 
     // Disposition
     Disposition disposition;
 
     // Time of the last warning
-    clock_type::rep lastWarningTime;
+    std::atomic <clock_type::rep> lastWarningTime;
 
     // For inactive entries, time after which this entry will be erased
     clock_type::rep whenExpires;
@@ -244,7 +244,7 @@ public:
             {
                 Json::Value& entry = (ret[iter->to_string()] = Json::objectValue);
                 entry["local"] = localBalance;
-                entry["remote"] = iter->remote_balance;
+                entry["remote"] = iter->remote_balance.load ();
                 entry["type"] = "outbound";
             }
 
@@ -257,7 +257,7 @@ public:
             {
                 Json::Value& entry = (ret[iter->to_string()] = Json::objectValue);
                 entry["local"] = localBalance;
-                entry["remote"] = iter->remote_balance;
+                entry["remote"] = iter->remote_balance.load ();
                 entry["type"] = "outbound";
             }
 
@@ -270,7 +270,7 @@ public:
             {
                 Json::Value& entry = (ret[iter->to_string()] = Json::objectValue);
                 entry["local"] = localBalance;
-                entry["remote"] = iter->remote_balance;
+                entry["remote"] = iter->remote_balance.load ();
                 entry["type"] = "admin";
             }
 
@@ -472,55 +472,6 @@ public:
         state->table.erase (iter);
     }
 
-    Disposition charge (Entry& entry, Charge const& fee, SharedState::Access& state)
-    {
-        clock_type::rep const now (m_clock.elapsed());
-        int const balance (entry.add (fee.cost(), now));
-        m_journal.trace <<
-            "Charging " << entry << " for " << fee;
-        return disposition (balance);
-    }
-
-    bool warn (Entry& entry, SharedState::Access& state)
-    {
-        bool notify (false);
-        clock_type::rep const now (m_clock.elapsed());
-        if (entry.balance (now) >= warningThreshold && now != entry.lastWarningTime)
-        {
-            charge (entry, feeWarning, state);
-            notify = true;
-            entry.lastWarningTime = now;
-        }
-
-        if (notify)
-            m_journal.info <<
-                "Load warning: " << entry;
-
-        if (notify)
-            ++m_stats.warn;
-
-        return notify;
-    }
-
-    bool disconnect (Entry& entry, SharedState::Access& state)
-    {
-        bool drop (false);
-        clock_type::rep const now (m_clock.elapsed());
-        if (entry.balance (now) >= dropThreshold)
-        {
-            charge (entry, feeDrop, state);
-            drop = true;
-        }
-        if (drop)
-            ++m_stats.drop;
-        return drop;
-    }
-
-    int balance (Entry& entry, SharedState::Access& state)
-    {
-        return entry.balance (m_clock.elapsed());
-    }
-
     //--------------------------------------------------------------------------
 
     void acquire (Entry& entry)
@@ -535,10 +486,17 @@ public:
         release (entry, state);
     }
 
+    // Charges are applied for every message, so these do not take the
+    // lock. A Consumer holds a reference to its entry, which keeps it in
+    // the table, and the balances it touches are atomic.
+
     Disposition charge (Entry& entry, Charge const& fee)
     {
-        SharedState::Access state (m_state);
-        return charge (entry, fee, state);
+        clock_type::rep const now (m_clock.elapsed());
+        int const balance (entry.add (fee.cost(), now));
+        m_journal.trace <<
+            "Charging " << entry << " for " << fee;
+        return disposition (balance);
     }
 
     bool warn (Entry& entry)
@@ -546,8 +504,20 @@ public:
         if (entry.admin())
             return false;
 
-        SharedState::Access state (m_state);
-        return warn (entry, state);
+        clock_type::rep const now (m_clock.elapsed());
+        if (entry.balance (now) < warningThreshold)
+            return false;
+
+        // At most one warning per second, even from concurrent callers
+        if (entry.lastWarningTime.exchange (now) == now)
+            return false;
+
+        charge (entry, feeWarning);
+
+        m_journal.info <<
+            "Load warning: " << entry;
+        ++m_stats.warn;
+        return true;
     }
 
     bool disconnect (Entry& entry)
@@ -555,14 +525,18 @@ public:
         if (entry.admin())
             return false;
 
-        SharedState::Access state (m_state);
-        return disconnect (entry, state);
+        clock_type::rep const now (m_clock.elapsed());
+        if (entry.balance (now) < dropThreshold)
+            return false;
+
+        charge (entry, feeDrop);
+        ++m_stats.drop;
+        return true;
     }
 
     int balance (Entry& entry)
     {
-        SharedState::Access state (m_state);
-        return balance (entry, state);
+        return entry.balance (m_clock.elapsed());
     }
 
     //--------------------------------------------------------------------------
@@ -580,8 +554,9 @@ public:
                 item ["count"] = iter->refcount;
             item ["name"] = iter->to_string();
             item ["balance"] = iter->balance(now);
-            if (iter->remote_balance != 0)
-                item ["remote_balance"] = iter->remote_balance;
+            int const remote_balance (iter->remote_balance.load ());
+            if (remote_balance != 0)
+                item ["remote_balance"] = remote_balance;
         }
     }
 
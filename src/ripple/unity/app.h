@@ -60,6 +60,8 @@
 
 #include <ripple/common/KeyCache.h>
 #include <ripple/common/TaggedCache.h>
+#include <ripple/common/ShardedTaggedCache.h>
+#include <ripple/common/SlabAllocator.h>
 
 #include <ripple/module/app/data/Database.h>
 #include <ripple/module/app/data/DatabaseCon.h>
@@ -113,6 +115,7 @@
 #include <ripple/module/app/ledger/OrderBookDB.h>
 #include <ripple/module/app/tx/TransactionAcquire.h>
 #include <ripple/module/app/tx/LocalTxs.h>
+#include <ripple/module/app/tx/SigVerifier.h>
 #include <ripple/module/app/consensus/DisputedTx.h>
 #include <ripple/module/app/consensus/LedgerConsensus.h>
 #include <ripple/module/app/ledger/LedgerTiming.h>
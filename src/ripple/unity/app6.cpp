@@ -24,6 +24,7 @@
 #include <ripple/common/seconds_clock.h>
 
 #include <ripple/module/app/ledger/LedgerEntrySet.cpp>
+#include <ripple/module/app/ledger/tests/LedgerEntrySet.test.cpp>
 #include <ripple/module/app/ledger/AcceptedLedger.cpp>
 #include <ripple/module/app/ledger/DirectoryEntryIterator.cpp>
 #include <ripple/module/app/ledger/OrderBookIterator.cpp>
@@ -33,4 +33,5 @@
 #include <ripple/module/app/tx/TxQueueEntry.h>
 #include <ripple/module/app/tx/TxQueue.h>
 #include <ripple/module/app/tx/LocalTxs.cpp>
+#include <ripple/module/app/tx/SigVerifier.cpp>
 #include <ripple/module/app/misc/NetworkOPs.cpp>
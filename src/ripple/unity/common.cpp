@@ -21,6 +21,8 @@
 
 #include <ripple/common/impl/KeyCache.cpp>
 #include <ripple/common/impl/TaggedCache.cpp>
+#include <ripple/common/impl/ShardedTaggedCache.cpp>
+#include <ripple/common/impl/SlabAllocator.cpp>
 #include <ripple/common/impl/ResolverAsio.cpp>
 #include <ripple/common/impl/MultiSocket.cpp>
 #include <ripple/common/impl/RippleSSLContext.cpp>
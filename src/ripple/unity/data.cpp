@@ -43,6 +43,8 @@
 #include <openssl/err.h>
 
 #include <ripple/unity/sslutil.h>
+#include <ripple/common/seconds_clock.h>
+#include <ripple/common/ShardedTaggedCache.h>
 #include <ripple/module/rpc/api/ErrorCodes.h>
 #include <ripple/common/jsonrpc_fields.h>
 
@@ -64,6 +66,7 @@
 #include <ripple/module/data/crypto/CKey.cpp>
 #include <ripple/module/data/crypto/CKeyDeterministic.cpp>
 #include <ripple/module/data/crypto/CKeyECIES.cpp>
+#include <ripple/module/data/crypto/PublicKeyCache.cpp>
 #include <ripple/module/data/crypto/Base58Data.cpp>
 #include <ripple/module/data/crypto/RFC1751.cpp>
 
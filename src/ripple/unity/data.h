@@ -24,11 +24,14 @@
 #include <ripple/unity/json.h>
 #include <ripple/sslutil/api/ECDSACanonical.h>
 
+#include <beast/Insight.h>
+
 struct bignum_st;
 typedef struct bignum_st BIGNUM;
 
 #include <ripple/module/data/crypto/Base58Data.h>
 #include <ripple/module/data/crypto/RFC1751.h>
+#include <ripple/module/data/crypto/PublicKeyCache.h>
 #include <ripple/module/data/protocol/BuildInfo.h>
 #include <ripple/module/data/protocol/FieldNames.h>
 #include <ripple/module/data/protocol/HashPrefix.h>
@@ -24,6 +24,9 @@
 #include <beast/module/core/system/BeforeBoost.h>
 #include <boost/utility/base_from_member.hpp>
 
+#include <atomic>
+#include <cstdint>
+
 #include <ripple/algorithm/api/DecayingSample.h>
 #include <ripple/common/seconds_clock.h>
 